@@ -142,15 +142,6 @@ static char*
 	return format_localtime(lt, sz_time, sizeof(sz_time));
 }
 
-// And now the same, but with user supplied storage, thus potentially thread-safe:
-// e.g., we use the stack in reaper_thread().
-static char*
-    get_current_time_r(struct tm* restrict local_tm, char* restrict sz_time, size_t len)
-{
-	struct tm* restrict lt = get_localtime(local_tm);
-	return format_localtime(lt, sz_time, len);
-}
-
 static const char*
     get_log_prefix(int prio)
 {
@@ -388,6 +379,398 @@ static int
 	return -EINVAL;
 }
 
+// Sanitize user input for keys expecting a (bounded) signed integer
+static int
+    strtol_ranged(const char* str, long int min, long int max, long int* restrict result)
+{
+	char* endptr;
+	errno        = 0;    // To distinguish success/failure after call
+	long int val = strtol(str, &endptr, 10);
+
+	if (errno != 0) {
+		PFLOG(LOG_WARNING, "strtol: %m");
+		return -EINVAL;
+	}
+
+	if (endptr == str) {
+		LOG(LOG_WARNING, "No digits were found in value '%s' assigned to a key expecting an integer.", str);
+		return -EINVAL;
+	}
+
+	if (*endptr != '\0') {
+		LOG(LOG_WARNING,
+		    "Found trailing characters (%s) behind value '%ld' assigned from string '%s' to a key expecting an integer.",
+		    endptr,
+		    val,
+		    str);
+		return -EINVAL;
+	}
+
+	if (val < min || val > max) {
+		LOG(LOG_WARNING, "Value '%ld' is out of range (expected a value between %ld and %ld).", val, min, max);
+		return -EINVAL;
+	}
+
+	*result = val;
+	return EXIT_SUCCESS;
+}
+
+// nice = -20 ... 19
+static int
+    parse_nice(const char* str, SpawnTuning* restrict tuning)
+{
+	long int val;
+	if (strtol_ranged(str, -20L, 19L, &val) < 0) {
+		return -EINVAL;
+	}
+
+	tuning->nice     = (int) val;
+	tuning->set_nice = true;
+	return EXIT_SUCCESS;
+}
+
+// ioprio = none | idle | best-effort[:0-7] | realtime[:0-7] (be & rt are accepted as shorthands)
+static int
+    parse_ioprio(const char* str, SpawnTuning* restrict tuning)
+{
+	char   class_name[16] = { 0 };
+	size_t len            = strcspn(str, ":");
+	if (len >= sizeof(class_name)) {
+		LOG(LOG_WARNING, "Unknown I/O scheduling class in '%s'.", str);
+		return -EINVAL;
+	}
+	memcpy(class_name, str, len);
+
+	int class;
+	if (strcasecmp(class_name, "none") == 0) {
+		class = IOPRIO_CLASS_NONE;
+	} else if (strcasecmp(class_name, "idle") == 0) {
+		class = IOPRIO_CLASS_IDLE;
+	} else if (strcasecmp(class_name, "best-effort") == 0 || strcasecmp(class_name, "be") == 0) {
+		class = IOPRIO_CLASS_BE;
+	} else if (strcasecmp(class_name, "realtime") == 0 || strcasecmp(class_name, "rt") == 0) {
+		class = IOPRIO_CLASS_RT;
+	} else {
+		LOG(LOG_WARNING, "Unknown I/O scheduling class in '%s'.", str);
+		return -EINVAL;
+	}
+
+	// NOTE: The kernel's default level is 4, and the idle class doesn't have any.
+	long int level = 4L;
+	if (str[len] == ':') {
+		if (class == IOPRIO_CLASS_NONE || class == IOPRIO_CLASS_IDLE) {
+			LOG(LOG_WARNING, "The %s I/O scheduling class doesn't take a priority level.", class_name);
+			return -EINVAL;
+		}
+		if (strtol_ranged(str + len + 1U, 0L, 7L, &level) < 0) {
+			return -EINVAL;
+		}
+	}
+
+	switch (class) {
+		case IOPRIO_CLASS_NONE:
+			tuning->ioprio = 0;
+			break;
+		case IOPRIO_CLASS_IDLE:
+			tuning->ioprio = IOPRIO_PRIO_VALUE(class, 0);
+			break;
+		default:
+			tuning->ioprio = IOPRIO_PRIO_VALUE(class, (int) level);
+			break;
+	}
+	return EXIT_SUCCESS;
+}
+
+// sched_policy = other | batch | idle | fifo:1-99 | rr:1-99
+static int
+    parse_sched(const char* str, SpawnTuning* restrict tuning)
+{
+	char   policy_name[16] = { 0 };
+	size_t len             = strcspn(str, ":");
+	if (len >= sizeof(policy_name)) {
+		LOG(LOG_WARNING, "Unknown scheduling policy in '%s'.", str);
+		return -EINVAL;
+	}
+	memcpy(policy_name, str, len);
+
+	int  policy;
+	bool is_rt = false;
+	if (strcasecmp(policy_name, "other") == 0 || strcasecmp(policy_name, "normal") == 0) {
+		policy = SCHED_OTHER;
+	} else if (strcasecmp(policy_name, "batch") == 0) {
+		policy = SCHED_BATCH;
+	} else if (strcasecmp(policy_name, "idle") == 0) {
+		policy = SCHED_IDLE;
+	} else if (strcasecmp(policy_name, "fifo") == 0) {
+		policy = SCHED_FIFO;
+		is_rt  = true;
+	} else if (strcasecmp(policy_name, "rr") == 0) {
+		policy = SCHED_RR;
+		is_rt  = true;
+	} else {
+		LOG(LOG_WARNING, "Unknown scheduling policy in '%s'.", str);
+		return -EINVAL;
+	}
+
+	// Only the realtime policies take a (mandatory) static priority
+	long int prio = 0L;
+	if (is_rt) {
+		if (str[len] != ':') {
+			LOG(LOG_WARNING, "The %s scheduling policy requires a priority (e.g., %s:10).", policy_name, policy_name);
+			return -EINVAL;
+		}
+		if (strtol_ranged(str + len + 1U, 1L, 99L, &prio) < 0) {
+			return -EINVAL;
+		}
+	} else if (str[len] != '\0') {
+		LOG(LOG_WARNING, "The %s scheduling policy doesn't take a priority.", policy_name);
+		return -EINVAL;
+	}
+
+	tuning->sched_policy   = policy;
+	tuning->sched_priority = (int) prio;
+	tuning->set_sched      = true;
+	return EXIT_SUCCESS;
+}
+
+// cpu_affinity = comma separated list of CPUs or ranges of CPUs (e.g., 0,2-3)
+static int
+    parse_cpu_affinity(const char* str, SpawnTuning* restrict tuning)
+{
+	char buf[CFG_SZ_MAX];
+	if (str5cpy(buf, sizeof(buf), str, CFG_SZ_MAX, NOTRUNC) < 0) {
+		return -EINVAL;
+	}
+
+	uint32_t mask = 0U;
+	char*    saveptr;
+	for (char* tok = strtok_r(buf, ", ", &saveptr); tok; tok = strtok_r(NULL, ", ", &saveptr)) {
+		long int first;
+		long int last;
+		char*    dash = strchr(tok, '-');
+		if (dash) {
+			*dash = '\0';
+			if (strtol_ranged(tok, 0L, 31L, &first) < 0 || strtol_ranged(dash + 1, 0L, 31L, &last) < 0) {
+				return -EINVAL;
+			}
+		} else {
+			if (strtol_ranged(tok, 0L, 31L, &first) < 0) {
+				return -EINVAL;
+			}
+			last = first;
+		}
+		if (first > last) {
+			LOG(LOG_WARNING, "Reversed CPU range (%ld-%ld).", first, last);
+			return -EINVAL;
+		}
+		for (long int cpu = first; cpu <= last; cpu++) {
+			mask |= (1U << cpu);
+		}
+	}
+
+	if (mask == 0U) {
+		LOG(LOG_WARNING, "Assigned an empty CPU list to a key expecting a list of CPUs.");
+		return -EINVAL;
+	}
+
+	tuning->cpu_mask = mask;
+	return EXIT_SUCCESS;
+}
+
+// Sanitize a single rlimit value: unlimited, or an amount, with an optional binary K/M/G suffix
+static int
+    strtorlim(const char* str, rlim_t* restrict result)
+{
+	if (strcasecmp(str, "unlimited") == 0 || strcasecmp(str, "infinity") == 0) {
+		*result = RLIM_INFINITY;
+		return EXIT_SUCCESS;
+	}
+
+	if (strchr(str, '-')) {
+		LOG(LOG_WARNING, "Assigned a negative value (%s) to a resource limit.", str);
+		return -EINVAL;
+	}
+
+	char* endptr;
+	errno                      = 0;
+	unsigned long long int val = strtoull(str, &endptr, 10);
+	if (errno != 0 || endptr == str) {
+		LOG(LOG_WARNING, "Assigned an invalid value (%s) to a resource limit.", str);
+		return -EINVAL;
+	}
+
+	unsigned int shift = 0U;
+	switch (*endptr) {
+		case '\0':
+			break;
+		case 'k':
+		case 'K':
+			shift = 10U;
+			break;
+		case 'm':
+		case 'M':
+			shift = 20U;
+			break;
+		case 'g':
+		case 'G':
+			shift = 30U;
+			break;
+		default:
+			LOG(LOG_WARNING, "Found an unknown suffix (%s) behind a resource limit.", endptr);
+			return -EINVAL;
+	}
+	if (shift && endptr[1] != '\0') {
+		LOG(LOG_WARNING, "Found trailing characters (%s) behind a resource limit.", endptr);
+		return -EINVAL;
+	}
+
+	// Make sure this fits in an rlim_t (which is only 32-bit wide on our targets), and doesn't alias RLIM_INFINITY
+	if (val > ((unsigned long long int) (RLIM_INFINITY - 1U) >> shift)) {
+		LOG(LOG_WARNING, "Resource limit '%s' is too large, use unlimited instead.", str);
+		return -EINVAL;
+	}
+
+	*result = (rlim_t) (val << shift);
+	return EXIT_SUCCESS;
+}
+
+// rlimit = comma separated list of resource:soft[:hard] (e.g., nofile:256, as:128M:256M)
+// NOTE: This appends, as it may be spread over multiple lines. If a resource is specified more than once, the last one wins.
+static int
+    parse_rlimits(const char* str, SpawnTuning* restrict tuning)
+{
+	static const struct
+	{
+		const char* name;
+		int         resource;
+	} resources[] = {
+		{ "as", RLIMIT_AS },	     { "core", RLIMIT_CORE },	{ "cpu", RLIMIT_CPU },
+		{ "data", RLIMIT_DATA },     { "fsize", RLIMIT_FSIZE },	{ "memlock", RLIMIT_MEMLOCK },
+		{ "nofile", RLIMIT_NOFILE }, { "nproc", RLIMIT_NPROC }, { "rss", RLIMIT_RSS },
+		{ "stack", RLIMIT_STACK },   { "nice", RLIMIT_NICE },	{ "rtprio", RLIMIT_RTPRIO },
+	};
+
+	char buf[CFG_SZ_MAX];
+	if (str5cpy(buf, sizeof(buf), str, CFG_SZ_MAX, NOTRUNC) < 0) {
+		return -EINVAL;
+	}
+
+	char* saveptr;
+	for (char* tok = strtok_r(buf, ", ", &saveptr); tok; tok = strtok_r(NULL, ", ", &saveptr)) {
+		char* soft = strchr(tok, ':');
+		if (!soft) {
+			LOG(LOG_WARNING, "Malformed resource limit '%s' (expected resource:soft[:hard]).", tok);
+			return -EINVAL;
+		}
+		*soft++    = '\0';
+		char* hard = strchr(soft, ':');
+		if (hard) {
+			*hard++ = '\0';
+		}
+
+		int resource = -1;
+		for (size_t i = 0U; i < sizeof(resources) / sizeof(*resources); i++) {
+			if (strcasecmp(tok, resources[i].name) == 0) {
+				resource = resources[i].resource;
+				break;
+			}
+		}
+		if (resource == -1) {
+			LOG(LOG_WARNING, "Unknown resource '%s' in resource limit.", tok);
+			return -EINVAL;
+		}
+
+		struct rlimit rlim;
+		if (strtorlim(soft, &rlim.rlim_cur) < 0) {
+			return -EINVAL;
+		}
+		// The hard limit defaults to the soft one
+		if (hard) {
+			if (strtorlim(hard, &rlim.rlim_max) < 0) {
+				return -EINVAL;
+			}
+		} else {
+			rlim.rlim_max = rlim.rlim_cur;
+		}
+		if (rlim.rlim_cur > rlim.rlim_max) {
+			LOG(LOG_WARNING, "The soft limit for resource '%s' is larger than its hard limit.", tok);
+			return -EINVAL;
+		}
+
+		// Replace, or append
+		uint8_t i;
+		for (i = 0U; i < tuning->rlimits_count; i++) {
+			if (tuning->rlimits[i].resource == resource) {
+				break;
+			}
+		}
+		if (i >= TUNING_RLIMITS_MAX) {
+			LOG(LOG_WARNING, "Too many resource limits (max is %d).", TUNING_RLIMITS_MAX);
+			return -EINVAL;
+		}
+		tuning->rlimits[i].resource = resource;
+		tuning->rlimits[i].rlim     = rlim;
+		if (i == tuning->rlimits_count) {
+			tuning->rlimits_count++;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
+
+// Compare two sets of scheduling & resource controls
+static bool
+    are_tunings_equal(const SpawnTuning* restrict a, const SpawnTuning* restrict b)
+{
+	if (a->set_nice != b->set_nice || (a->set_nice && a->nice != b->nice)) {
+		return false;
+	}
+	if (a->set_sched != b->set_sched ||
+	    (a->set_sched && (a->sched_policy != b->sched_policy || a->sched_priority != b->sched_priority))) {
+		return false;
+	}
+	if (a->ioprio != b->ioprio || a->cpu_mask != b->cpu_mask || strcmp(a->cgroup, b->cgroup) != 0) {
+		return false;
+	}
+	if (a->rlimits_count != b->rlimits_count) {
+		return false;
+	}
+	for (uint8_t i = 0U; i < a->rlimits_count; i++) {
+		if (a->rlimits[i].resource != b->rlimits[i].resource ||
+		    a->rlimits[i].rlim.rlim_cur != b->rlimits[i].rlim.rlim_cur ||
+		    a->rlimits[i].rlim.rlim_max != b->rlimits[i].rlim.rlim_max) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Pretty-print a set of scheduling & resource controls, for logging purposes
+static char*
+    format_tuning(const SpawnTuning* restrict tuning, char* restrict buf, size_t len)
+{
+	// NOTE: Match the order in which spawn_child applies them
+	int ret = snprintf(buf,
+			   len,
+			   "cgroup=%s, rlimits=%hhu, cpu_affinity=%#x, sched_policy=%d:%d%s, ioprio=%d:%d, nice=%d%s",
+			   tuning->cgroup,
+			   tuning->rlimits_count,
+			   tuning->cpu_mask,
+			   tuning->sched_policy,
+			   tuning->sched_priority,
+			   tuning->set_sched ? "" : " (inherited)",
+			   tuning->ioprio >> IOPRIO_CLASS_SHIFT,
+			   tuning->ioprio & ((1 << IOPRIO_CLASS_SHIFT) - 1),
+			   tuning->nice,
+			   tuning->set_nice ? "" : " (inherited)");
+	if (ret < 0) {
+		buf[0] = '\0';
+	}
+
+	return buf;
+}
+
 // Handle parsing the main KFMon config
 static int
     daemon_handler(void* user, const char* restrict section, const char* restrict key, const char* restrict value)
@@ -447,6 +830,11 @@ static int
 			LOG(LOG_CRIT, "Passed an invalid value for block_spawns!");
 			return 0;
 		}
+	} else if (MATCH("watch", "standby")) {
+		if (strtobool(value, &pconfig->standby) < 0) {
+			LOG(LOG_CRIT, "Passed an invalid value for standby!");
+			return 0;
+		}
 	} else if (MATCH("watch", "skip_db_checks")) {
 		if (strtobool(value, &pconfig->skip_db_checks) < 0) {
 			LOG(LOG_CRIT, "Passed an invalid value for skip_db_checks!");
@@ -457,6 +845,52 @@ static int
 			LOG(LOG_CRIT, "Passed an invalid value for do_db_update!");
 			return 0;
 		}
+	} else if (MATCH("watch", "prefetch")) {
+		// NOTE: Append, as this may be spread over multiple lines.
+		size_t cur = strlen(pconfig->prefetch);
+		int    ret = snprintf(pconfig->prefetch + cur,
+				       sizeof(pconfig->prefetch) - cur,
+				       "%s%s",
+				       cur ? "," : "",
+				       value);
+		if (ret < 0 || (size_t) ret >= sizeof(pconfig->prefetch) - cur) {
+			LOG(LOG_CRIT, "Passed an invalid value for prefetch (too long?)!");
+			return 0;
+		}
+	} else if (MATCH("watch", "nice")) {
+		if (parse_nice(value, &pconfig->tuning) < 0) {
+			LOG(LOG_CRIT, "Passed an invalid value for nice!");
+			return 0;
+		}
+	} else if (MATCH("watch", "ioprio")) {
+		if (parse_ioprio(value, &pconfig->tuning) < 0) {
+			LOG(LOG_CRIT, "Passed an invalid value for ioprio!");
+			return 0;
+		}
+	} else if (MATCH("watch", "sched_policy")) {
+		if (parse_sched(value, &pconfig->tuning) < 0) {
+			LOG(LOG_CRIT, "Passed an invalid value for sched_policy!");
+			return 0;
+		}
+	} else if (MATCH("watch", "cpu_affinity")) {
+		if (parse_cpu_affinity(value, &pconfig->tuning) < 0) {
+			LOG(LOG_CRIT, "Passed an invalid value for cpu_affinity!");
+			return 0;
+		}
+	} else if (MATCH("watch", "rlimit")) {
+		if (parse_rlimits(value, &pconfig->tuning) < 0) {
+			LOG(LOG_CRIT, "Passed an invalid value for rlimit!");
+			return 0;
+		}
+	} else if (MATCH("watch", "cgroup")) {
+		if (value[0] != '/') {
+			LOG(LOG_CRIT, "Passed an invalid value for cgroup (not an absolute path)!");
+			return 0;
+		}
+		if (str5cpy(pconfig->tuning.cgroup, CFG_SZ_MAX, value, CFG_SZ_MAX, NOTRUNC) < 0) {
+			LOG(LOG_CRIT, "Passed an invalid value for cgroup (too long?)!");
+			return 0;
+		}
 	} else if (MATCH("watch", "db_title")) {
 		// NOTE: str5cpy returns OKTRUNC (1) if we allow truncation, which we do here
 		if (str5cpy(pconfig->db_title, DB_SZ_MAX, value, DB_SZ_MAX, TRUNC) != 0) {
@@ -480,7 +914,7 @@ static int
 
 // Validate a watch config
 static bool
-    validate_watch_config(void* user)
+    validate_watch_config(void* user, const WatchConfig* table)
 {
 	WatchConfig* restrict pconfig = (WatchConfig*) user;
 
@@ -496,16 +930,16 @@ static bool
 		uint8_t bmatches = 0U;
 		for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
 			// Only relevant for active watches
-			if (!watchConfig[watch_idx].is_active) {
+			if (!table[watch_idx].is_active) {
 				continue;
 			}
 
-			if (strcmp(pconfig->filename, watchConfig[watch_idx].filename) == 0) {
+			if (strcmp(pconfig->filename, table[watch_idx].filename) == 0) {
 				matches++;
 			}
 
 			// Check the basename, too, for IPC...
-			if (strcmp(basename(pconfig->filename), basename(watchConfig[watch_idx].filename)) == 0) {
+			if (strcmp(basename(pconfig->filename), basename(table[watch_idx].filename)) == 0) {
 				bmatches++;
 			}
 		}
@@ -549,7 +983,7 @@ static bool
 
 // Validate a watch config, and merge it to its final location if it's sane and updated
 static bool
-    validate_and_merge_watch_config(void* user, uint8_t target_idx, bool* was_updated)
+    validate_and_merge_watch_config(void* user, WatchConfig* table, uint8_t target_idx, bool* was_updated)
 {
 	WatchConfig* restrict pconfig = (WatchConfig*) user;
 
@@ -561,14 +995,14 @@ static bool
 		sane = false;
 	} else {
 		// Did it change?
-		if (strcmp(pconfig->filename, watchConfig[target_idx].filename) != 0) {
+		if (strcmp(pconfig->filename, table[target_idx].filename) != 0) {
 			// Make sure we're not trying to set multiple watches on the same file...
 			// (because that would only actually register the first one parsed).
 			uint8_t matches  = 0U;
 			uint8_t bmatches = 0U;
 			for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
 				// Only relevant for active watches
-				if (!watchConfig[watch_idx].is_active) {
+				if (!table[watch_idx].is_active) {
 					continue;
 				}
 
@@ -577,12 +1011,12 @@ static bool
 					continue;
 				}
 
-				if (strcmp(pconfig->filename, watchConfig[watch_idx].filename) == 0) {
+				if (strcmp(pconfig->filename, table[watch_idx].filename) == 0) {
 					matches++;
 				}
 
 				// Check basename, too, for IPC...
-				if (strcmp(basename(pconfig->filename), basename(watchConfig[watch_idx].filename)) == 0) {
+				if (strcmp(basename(pconfig->filename), basename(table[watch_idx].filename)) == 0) {
 					bmatches++;
 				}
 			}
@@ -600,12 +1034,11 @@ static bool
 			if (sane) {
 				// Filename changed, and it was updated to something sane, update our target watch!
 				// NOTE: Forgo error checking, as this has already gone through an input validation pass.
-				str5cpy(
-				    watchConfig[target_idx].filename, CFG_SZ_MAX, pconfig->filename, CFG_SZ_MAX, NOTRUNC);
+				str5cpy(table[target_idx].filename, CFG_SZ_MAX, pconfig->filename, CFG_SZ_MAX, NOTRUNC);
 				updated = true;
 				LOG(LOG_NOTICE,
 				    "Updated filename to '%s' for watch config @ index %hhu",
-				    watchConfig[target_idx].filename,
+				    table[target_idx].filename,
 				    target_idx);
 			}
 		}
@@ -614,63 +1047,94 @@ static bool
 		LOG(LOG_CRIT, "Mandatory key 'action' is missing or blank!");
 		sane = false;
 	} else {
-		if (strcmp(pconfig->action, watchConfig[target_idx].action) != 0) {
-			str5cpy(watchConfig[target_idx].action, CFG_SZ_MAX, pconfig->action, CFG_SZ_MAX, NOTRUNC);
+		if (strcmp(pconfig->action, table[target_idx].action) != 0) {
+			str5cpy(table[target_idx].action, CFG_SZ_MAX, pconfig->action, CFG_SZ_MAX, NOTRUNC);
 			updated = true;
 			LOG(LOG_NOTICE,
 			    "Updated action to '%s' for watch config @ index %hhu",
-			    watchConfig[target_idx].action,
+			    table[target_idx].action,
 			    target_idx);
 		}
 	}
 
 	// Check if label was updated...
-	if (strcmp(pconfig->label, watchConfig[target_idx].label) != 0) {
-		str5cpy(watchConfig[target_idx].label, CFG_SZ_MAX, pconfig->label, CFG_SZ_MAX, TRUNC);
+	if (strcmp(pconfig->label, table[target_idx].label) != 0) {
+		str5cpy(table[target_idx].label, CFG_SZ_MAX, pconfig->label, CFG_SZ_MAX, TRUNC);
 		updated = true;
 		LOG(LOG_NOTICE,
 		    "Updated label to '%s' for watch config @ index %hhu",
-		    watchConfig[target_idx].label,
+		    table[target_idx].label,
 		    target_idx);
 	}
 
 	// Check if hidden was updated...
-	if (pconfig->hidden != watchConfig[target_idx].hidden) {
-		watchConfig[target_idx].hidden = pconfig->hidden;
-		updated                        = true;
+	if (pconfig->hidden != table[target_idx].hidden) {
+		table[target_idx].hidden = pconfig->hidden;
+		updated                  = true;
 		LOG(LOG_NOTICE,
 		    "Updated hidden to %s for watch config @ index %hhu",
-		    BOOL2STR(watchConfig[target_idx].hidden),
+		    BOOL2STR(table[target_idx].hidden),
 		    target_idx);
 	}
 
 	// Check if block_spawns was updated...
-	if (pconfig->block_spawns != watchConfig[target_idx].block_spawns) {
-		watchConfig[target_idx].block_spawns = pconfig->block_spawns;
-		updated                              = true;
+	if (pconfig->block_spawns != table[target_idx].block_spawns) {
+		table[target_idx].block_spawns = pconfig->block_spawns;
+		updated                        = true;
 		LOG(LOG_NOTICE,
 		    "Updated block_spawns to %s for watch config @ index %hhu",
-		    BOOL2STR(watchConfig[target_idx].block_spawns),
+		    BOOL2STR(table[target_idx].block_spawns),
+		    target_idx);
+	}
+
+	// Check if prefetch was updated...
+	if (strcmp(pconfig->prefetch, table[target_idx].prefetch) != 0) {
+		str5cpy(table[target_idx].prefetch, PREFETCH_SZ_MAX, pconfig->prefetch, PREFETCH_SZ_MAX, NOTRUNC);
+		updated = true;
+		LOG(LOG_NOTICE,
+		    "Updated prefetch to '%s' for watch config @ index %hhu",
+		    table[target_idx].prefetch,
+		    target_idx);
+	}
+
+	// Check if the scheduling & resource controls were updated...
+	if (!are_tunings_equal(&pconfig->tuning, &table[target_idx].tuning)) {
+		table[target_idx].tuning = pconfig->tuning;
+		updated                  = true;
+		char buf[256];
+		LOG(LOG_NOTICE,
+		    "Updated scheduling & resource controls to %s for watch config @ index %hhu",
+		    format_tuning(&table[target_idx].tuning, buf, sizeof(buf)),
+		    target_idx);
+	}
+
+	// Check if standby was updated...
+	if (pconfig->standby != table[target_idx].standby) {
+		table[target_idx].standby = pconfig->standby;
+		updated                   = true;
+		LOG(LOG_NOTICE,
+		    "Updated standby to %s for watch config @ index %hhu",
+		    BOOL2STR(table[target_idx].standby),
 		    target_idx);
 	}
 
 	// Check if skip_db_checks was updated...
-	if (pconfig->skip_db_checks != watchConfig[target_idx].skip_db_checks) {
-		watchConfig[target_idx].skip_db_checks = pconfig->skip_db_checks;
-		updated                                = true;
+	if (pconfig->skip_db_checks != table[target_idx].skip_db_checks) {
+		table[target_idx].skip_db_checks = pconfig->skip_db_checks;
+		updated                          = true;
 		LOG(LOG_NOTICE,
 		    "Updated skip_db_checks to %s for watch config @ index %hhu",
-		    BOOL2STR(watchConfig[target_idx].skip_db_checks),
+		    BOOL2STR(table[target_idx].skip_db_checks),
 		    target_idx);
 	}
 
 	// Check if do_db_update was updated...
-	if (pconfig->do_db_update != watchConfig[target_idx].do_db_update) {
-		watchConfig[target_idx].do_db_update = pconfig->do_db_update;
-		updated                              = true;
+	if (pconfig->do_db_update != table[target_idx].do_db_update) {
+		table[target_idx].do_db_update = pconfig->do_db_update;
+		updated                        = true;
 		LOG(LOG_NOTICE,
 		    "Updated do_db_update to %s for watch config @ index %hhu",
-		    BOOL2STR(watchConfig[target_idx].do_db_update),
+		    BOOL2STR(table[target_idx].do_db_update),
 		    target_idx);
 	}
 
@@ -680,12 +1144,12 @@ static bool
 			LOG(LOG_CRIT, "Mandatory key 'db_title' is missing or blank!");
 			sane = false;
 		} else {
-			if (strcmp(pconfig->db_title, watchConfig[target_idx].db_title) != 0) {
-				str5cpy(watchConfig[target_idx].db_title, DB_SZ_MAX, pconfig->db_title, DB_SZ_MAX, TRUNC);
+			if (strcmp(pconfig->db_title, table[target_idx].db_title) != 0) {
+				str5cpy(table[target_idx].db_title, DB_SZ_MAX, pconfig->db_title, DB_SZ_MAX, TRUNC);
 				updated = true;
 				LOG(LOG_NOTICE,
 				    "Updated db_title to '%s' for watch config @ index %hhu",
-				    watchConfig[target_idx].db_title,
+				    table[target_idx].db_title,
 				    target_idx);
 			}
 		}
@@ -693,13 +1157,12 @@ static bool
 			LOG(LOG_CRIT, "Mandatory key 'db_author' is missing or blank!");
 			sane = false;
 		} else {
-			if (strcmp(pconfig->db_author, watchConfig[target_idx].db_author) != 0) {
-				str5cpy(
-				    watchConfig[target_idx].db_author, DB_SZ_MAX, pconfig->db_author, DB_SZ_MAX, TRUNC);
+			if (strcmp(pconfig->db_author, table[target_idx].db_author) != 0) {
+				str5cpy(table[target_idx].db_author, DB_SZ_MAX, pconfig->db_author, DB_SZ_MAX, TRUNC);
 				updated = true;
 				LOG(LOG_NOTICE,
 				    "Updated db_author to '%s' for watch config @ index %hhu",
-				    watchConfig[target_idx].db_author,
+				    table[target_idx].db_author,
 				    target_idx);
 			}
 		}
@@ -707,20 +1170,19 @@ static bool
 			LOG(LOG_CRIT, "Mandatory key 'db_comment' is missing or blank!");
 			sane = false;
 		} else {
-			if (strcmp(pconfig->db_comment, watchConfig[target_idx].db_comment) != 0) {
-				str5cpy(
-				    watchConfig[target_idx].db_comment, DB_SZ_MAX, pconfig->db_comment, DB_SZ_MAX, TRUNC);
+			if (strcmp(pconfig->db_comment, table[target_idx].db_comment) != 0) {
+				str5cpy(table[target_idx].db_comment, DB_SZ_MAX, pconfig->db_comment, DB_SZ_MAX, TRUNC);
 				updated = true;
 				LOG(LOG_NOTICE,
 				    "Updated db_comment to '%s' for watch config @ index %hhu",
-				    watchConfig[target_idx].db_comment,
+				    table[target_idx].db_comment,
 				    target_idx);
 			}
 		}
 	}
 
 	if (sane && updated) {
-		FB_PRINTF("[KFMon] Updated the watch on %s", basename(watchConfig[target_idx].filename));
+		FB_PRINTF("[KFMon] Updated the watch on %s", basename(table[target_idx].filename));
 		// Notify the caller
 		*was_updated = true;
 	}
@@ -730,10 +1192,10 @@ static bool
 
 // Returns the index of the first usable entry in the watch list
 static int8_t
-    get_next_available_watch_entry(void)
+    get_next_available_watch_entry(const WatchConfig* table)
 {
 	for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
-		if (!watchConfig[watch_idx].is_active) {
+		if (!table[watch_idx].is_active && !table[watch_idx].pending_release) {
 			return (int8_t) watch_idx;
 		}
 	}
@@ -852,9 +1314,10 @@ static int
 							    p->fts_name,
 							    ret);
 						} else {
-							if (validate_watch_config(&watchConfig[watch_count])) {
+							if (validate_watch_config(
+								&watchConfig[watch_count], watchConfig)) {
 								LOG(LOG_NOTICE,
-								    "Watch config @ index %hhu loaded from '%s': filename=%s, action=%s, label=%s, hidden=%s, block_spawns=%s, do_db_update=%s, db_title=%s, db_author=%s, db_comment=%s",
+								    "Watch config @ index %hhu loaded from '%s': filename=%s, action=%s, label=%s, hidden=%s, block_spawns=%s, standby=%s, do_db_update=%s, db_title=%s, db_author=%s, db_comment=%s",
 								    watch_count,
 								    p->fts_name,
 								    watchConfig[watch_count].filename,
@@ -862,6 +1325,7 @@ static int
 								    watchConfig[watch_count].label,
 								    BOOL2STR(watchConfig[watch_count].hidden),
 								    BOOL2STR(watchConfig[watch_count].block_spawns),
+								    BOOL2STR(watchConfig[watch_count].standby),
 								    BOOL2STR(watchConfig[watch_count].do_db_update),
 								    watchConfig[watch_count].db_title,
 								    watchConfig[watch_count].db_author,
@@ -917,9 +1381,10 @@ static int
 	       daemonConfig.db_timeout,
 	       BOOL2STR(daemonConfig.use_syslog),
 	       BOOL2STR(daemonConfig.with_notifications));
+	char tuning_buf[256];
 	for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
 		DBGLOG(
-		    "Watch config @ index %hhu recap: active=%s, filename=%s, action=%s, label=%s, hidden=%s, block_spawns=%s, skip_db_checks=%s, do_db_update=%s, db_title=%s, db_author=%s, db_comment=%s",
+		    "Watch config @ index %hhu recap: active=%s, filename=%s, action=%s, label=%s, hidden=%s, block_spawns=%s, standby=%s, skip_db_checks=%s, do_db_update=%s, db_title=%s, db_author=%s, db_comment=%s, prefetch=%s, %s",
 		    watch_idx,
 		    BOOL2STR(watchConfig[watch_idx].is_active),
 		    watchConfig[watch_idx].filename,
@@ -927,21 +1392,54 @@ static int
 		    watchConfig[watch_idx].label,
 		    BOOL2STR(watchConfig[watch_idx].hidden),
 		    BOOL2STR(watchConfig[watch_idx].block_spawns),
+		    BOOL2STR(watchConfig[watch_idx].standby),
 		    BOOL2STR(watchConfig[watch_idx].skip_db_checks),
 		    BOOL2STR(watchConfig[watch_idx].do_db_update),
 		    watchConfig[watch_idx].db_title,
 		    watchConfig[watch_idx].db_author,
-		    watchConfig[watch_idx].db_comment);
+		    watchConfig[watch_idx].db_comment,
+		    watchConfig[watch_idx].prefetch,
+		    format_tuning(&watchConfig[watch_idx].tuning, tuning_buf, sizeof(tuning_buf)));
 	}
 #endif
 
 	return rval;
 }
 
+// Get the spare watch table ready for an update, starting from a copy of the current one (c.f., watchTables).
+static WatchConfig*
+    begin_watch_table_update(void)
+{
+	WatchConfig* next = (watchConfig == watchTables[0]) ? watchTables[1] : watchTables[0];
+	memcpy(next, watchConfig, sizeof(watchTables[0]));
+	return next;
+}
+
+// Publish an updated watch table (c.f., begin_watch_table_update) in one go.
+static void
+    publish_watch_table(WatchConfig* next)
+{
+	__atomic_store_n(&watchConfig, next, __ATOMIC_RELEASE);
+	__atomic_add_fetch(&watchConfigGen, 1U, __ATOMIC_RELEASE);
+}
+
+// Release the slot of a watch that isn't running anymore, by publishing a table without it.
+static void
+    release_watch_slot(uint8_t watch_idx)
+{
+	WatchConfig* next = begin_watch_table_update();
+	next[watch_idx]   = (const WatchConfig){ 0 };
+	publish_watch_table(next);
+	LOG(LOG_NOTICE, "Released watch slot %hhu.", watch_idx);
+}
+
 // Check if watch configs have been added/removed/updated...
 static int
     update_watch_configs(void)
 {
+	// Build the updated watch table off to the side, and only publish it once we're done (c.f., watchTables).
+	WatchConfig* next = begin_watch_table_update();
+
 	// Walk the config directory to pickup our ini files... (c.f.,
 	// https://keramida.wordpress.com/2009/07/05/fts3-or-avoiding-to-reinvent-the-wheel/)
 	// We only need to walk a single directory...
@@ -972,10 +1470,12 @@ static int
 
 	// Keep track of which watch indexes are up-to-date, so we can drop stale watches if some configs were deleted.
 	// NOTE: Init to -1 because 0 is a valid watch index ;).
-	int8_t  new_watch_list[WATCH_MAX] = { [0 ... WATCH_MAX - 1] = -1 };
-	uint8_t new_watch_count           = 0U;
+	int8_t   new_watch_list[WATCH_MAX] = { [0 ... WATCH_MAX - 1] = -1 };
+	uint8_t  new_watch_count           = 0U;
 	// If there was a meaningful update, we'll update the IPC socket's mtime as a hint to clients that new data is available.
-	bool    notify_update             = false;
+	bool     notify_update             = false;
+	// Which of the existing watches were updated in place (for our IPC subscribers)
+	uint32_t updated_watches           = 0U;
 
 	FTSENT* restrict p;
 	while ((p = fts_read(ftsp)) != NULL) {
@@ -1015,12 +1515,12 @@ static int
 							bool    is_new_watch = true;
 							for (watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
 								// Only check active watches
-								if (!watchConfig[watch_idx].is_active) {
+								if (!next[watch_idx].is_active) {
 									continue;
 								}
 
 								if (strcmp(cur_watch.filename,
-									   watchConfig[watch_idx].filename) == 0) {
+									   next[watch_idx].filename) == 0) {
 									// Gotcha!
 									is_new_watch = false;
 									// And we're good!
@@ -1030,7 +1530,8 @@ static int
 
 							if (is_new_watch) {
 								// New watch! Make it so!
-								int8_t new_watch_idx = get_next_available_watch_entry();
+								int8_t new_watch_idx =
+								    get_next_available_watch_entry(next);
 								if (new_watch_idx < 0) {
 									// Discard it if we already have the maximum amount of watches set up
 									LOG(LOG_WARNING,
@@ -1038,37 +1539,38 @@ static int
 									    p->fts_name,
 									    WATCH_MAX);
 								} else {
-									watch_idx              = (uint8_t) new_watch_idx;
-									watchConfig[watch_idx] = cur_watch;
+									watch_idx       = (uint8_t) new_watch_idx;
+									next[watch_idx] = cur_watch;
 
 									if (validate_watch_config(
-										&watchConfig[watch_idx])) {
+										&next[watch_idx], next)) {
 										LOG(LOG_NOTICE,
-										    "Watch config @ index %hhu loaded from '%s': filename=%s, action=%s, label=%s, hidden=%s, block_spawns=%s, do_db_update=%s, db_title=%s, db_author=%s, db_comment=%s",
+										    "Watch config @ index %hhu loaded from '%s': filename=%s, action=%s, label=%s, hidden=%s, block_spawns=%s, standby=%s, do_db_update=%s, db_title=%s, db_author=%s, db_comment=%s",
 										    watch_idx,
 										    p->fts_name,
-										    watchConfig[watch_idx].filename,
-										    watchConfig[watch_idx].action,
-										    watchConfig[watch_idx].label,
-										    BOOL2STR(
-											watchConfig[watch_idx].hidden),
-										    BOOL2STR(watchConfig[watch_idx]
+										    next[watch_idx].filename,
+										    next[watch_idx].action,
+										    next[watch_idx].label,
+										    BOOL2STR(next[watch_idx].hidden),
+										    BOOL2STR(next[watch_idx]
 												 .block_spawns),
-										    BOOL2STR(watchConfig[watch_idx]
+										    BOOL2STR(next[watch_idx].standby),
+										    BOOL2STR(next[watch_idx]
 												 .do_db_update),
-										    watchConfig[watch_idx].db_title,
-										    watchConfig[watch_idx].db_author,
-										    watchConfig[watch_idx].db_comment);
-
-										// Flag it as active
-										watchConfig[watch_idx].is_active = true;
+										    next[watch_idx].db_title,
+										    next[watch_idx].db_author,
+										    next[watch_idx].db_comment);
+
+										// Flag it as active, with a clean slate
+										next[watch_idx].is_active = true;
+										spawnStats[watch_idx] =
+										    (const SpawnStats){ 0 };
 										new_watch_list[new_watch_count++] =
 										    (int8_t) watch_idx;
 
 										FB_PRINTF(
 										    "[KFMon] Setup a new watch on %s",
-										    basename(
-											watchConfig[watch_idx].filename));
+										    basename(next[watch_idx].filename));
 
 										// New stuff!
 										notify_update = true;
@@ -1078,23 +1580,22 @@ static int
 										    p->fts_name);
 
 										// Clear the slot
-										watchConfig[watch_idx] =
+										next[watch_idx] =
 										    (const WatchConfig){ 0 };
 									}
 								}
 							} else {
 								// Updated watch!
-								pthread_mutex_lock(&ptlock);
 								bool is_watch_spawned =
 								    is_watch_already_spawned(watch_idx);
-								pthread_mutex_unlock(&ptlock);
 								// Don't do anything if it's already running...
+								// NOTE: Running processes only refer to their watch by index, so its slot can't change under their feet.
 								if (is_watch_spawned) {
 									LOG(LOG_INFO,
 									    "Cannot update watch slot %hhu (%s => %s), as it's currently running! Discarding potentially new data from '%s'!",
 									    watch_idx,
-									    basename(watchConfig[watch_idx].filename),
-									    basename(watchConfig[watch_idx].action),
+									    basename(next[watch_idx].filename),
+									    basename(next[watch_idx].action),
 									    p->fts_name);
 
 									// Don't forget to flag it as a keeper...
@@ -1104,7 +1605,10 @@ static int
 									bool was_updated = false;
 									// Validate what was parsed, and merge it if it's sane!
 									if (validate_and_merge_watch_config(
-										&cur_watch, watch_idx, &was_updated)) {
+										&cur_watch,
+										next,
+										watch_idx,
+										&was_updated)) {
 										// NOTE: validate_and_merge takes care of both
 										//       logging and updating the watch data
 										new_watch_list[new_watch_count++] =
@@ -1113,6 +1617,8 @@ static int
 										// Updated stuff!
 										if (was_updated) {
 											notify_update = true;
+											updated_watches |=
+											    1U << watch_idx;
 										}
 
 									} else {
@@ -1122,12 +1628,11 @@ static int
 
 										FB_PRINTF(
 										    "[KFMon] Dropped the watch on %s!",
-										    basename(
-											watchConfig[watch_idx].filename));
+										    basename(next[watch_idx].filename));
 
 										// Don't keep the previous state around,
 										// clear the slot.
-										watchConfig[watch_idx] =
+										next[watch_idx] =
 										    (const WatchConfig){ 0 };
 										LOG(LOG_NOTICE,
 										    "Released watch slot %hhu.",
@@ -1152,7 +1657,7 @@ static int
 	// or if an existing config file was updated, but failed to pass watch_handler @ ini_parse).
 	for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
 		// It of course needs to be active first so it can potentially be stale ;)
-		if (!watchConfig[watch_idx].is_active) {
+		if (!next[watch_idx].is_active) {
 			continue;
 		}
 
@@ -1170,19 +1675,43 @@ static int
 			LOG(LOG_WARNING,
 			    "Watch config @ index %hhu (%s => %s) is still active, but its config file is either gone or broken! Discarding it!",
 			    watch_idx,
-			    basename(watchConfig[watch_idx].filename),
-			    basename(watchConfig[watch_idx].action));
+			    basename(next[watch_idx].filename),
+			    basename(next[watch_idx].action));
 
-			FB_PRINTF("[KFMon] Dropped the watch on %s!", basename(watchConfig[watch_idx].filename));
+			FB_PRINTF("[KFMon] Dropped the watch on %s!", basename(next[watch_idx].filename));
 
-			watchConfig[watch_idx] = (const WatchConfig){ 0 };
-			LOG(LOG_NOTICE, "Released watch slot %hhu.", watch_idx);
+			// If it's currently running, keep the slot reserved until it's reaped.
+			if (is_watch_already_spawned(watch_idx)) {
+				next[watch_idx].is_active       = false;
+				next[watch_idx].pending_release = true;
+				LOG(LOG_NOTICE, "Watch slot %hhu will be released once its process exits.", watch_idx);
+			} else {
+				next[watch_idx] = (const WatchConfig){ 0 };
+				LOG(LOG_NOTICE, "Released watch slot %hhu.", watch_idx);
+			}
 
 			// Stale stuff!
 			notify_update = true;
 		}
 	}
 
+	// Publish the new table in one go
+	// NOTE: The previous one is left alone until the next update, so we can still diff against it.
+	const WatchConfig* prev = watchConfig;
+	publish_watch_table(next);
+	daemonStats.rebuilds++;
+
+	// Let our IPC subscribers know what changed
+	for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
+		if (!prev[watch_idx].is_active && next[watch_idx].is_active) {
+			NOTIFY_SUBSCRIBERS("watch:added:%hhu:%s", watch_idx, basename(next[watch_idx].filename));
+		} else if (prev[watch_idx].is_active && !next[watch_idx].is_active) {
+			NOTIFY_SUBSCRIBERS("watch:removed:%hhu", watch_idx);
+		} else if (updated_watches & (1U << watch_idx)) {
+			NOTIFY_SUBSCRIBERS("watch:updated:%hhu", watch_idx);
+		}
+	}
+
 	// There were meaningful updates, update the IPC socket's mtime!
 	if (notify_update) {
 		// Leave atime alone, update mtime to now
@@ -1193,49 +1722,158 @@ static int
 		if (utimensat(0, KFMON_IPC_SOCKET, times, 0) == -1) {
 			PFLOG(LOG_WARNING, "utimensat: %m");
 		}
+		if (utimensat(0, KFMON_IPC_SEQPACKET_SOCKET, times, 0) == -1) {
+			PFLOG(LOG_WARNING, "utimensat: %m");
+		}
 	}
 
 #ifdef DEBUG
 	// Let's recap (including failures)...
+	char tuning_buf[256];
 	for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
 		DBGLOG(
-		    "Watch config @ index %hhu recap: active=%s, filename=%s, action=%s, label=%s, hidden=%s, block_spawns=%s, skip_db_checks=%s, do_db_update=%s, db_title=%s, db_author=%s, db_comment=%s",
+		    "Watch config @ index %hhu recap: active=%s, filename=%s, action=%s, label=%s, hidden=%s, block_spawns=%s, standby=%s, skip_db_checks=%s, do_db_update=%s, db_title=%s, db_author=%s, db_comment=%s, prefetch=%s, %s",
 		    watch_idx,
-		    BOOL2STR(watchConfig[watch_idx].is_active),
-		    watchConfig[watch_idx].filename,
-		    watchConfig[watch_idx].action,
-		    watchConfig[watch_idx].label,
-		    BOOL2STR(watchConfig[watch_idx].hidden),
-		    BOOL2STR(watchConfig[watch_idx].block_spawns),
-		    BOOL2STR(watchConfig[watch_idx].skip_db_checks),
-		    BOOL2STR(watchConfig[watch_idx].do_db_update),
-		    watchConfig[watch_idx].db_title,
-		    watchConfig[watch_idx].db_author,
-		    watchConfig[watch_idx].db_comment);
+		    BOOL2STR(next[watch_idx].is_active),
+		    next[watch_idx].filename,
+		    next[watch_idx].action,
+		    next[watch_idx].label,
+		    BOOL2STR(next[watch_idx].hidden),
+		    BOOL2STR(next[watch_idx].block_spawns),
+		    BOOL2STR(next[watch_idx].standby),
+		    BOOL2STR(next[watch_idx].skip_db_checks),
+		    BOOL2STR(next[watch_idx].do_db_update),
+		    next[watch_idx].db_title,
+		    next[watch_idx].db_author,
+		    next[watch_idx].db_comment,
+		    next[watch_idx].prefetch,
+		    format_tuning(&next[watch_idx].tuning, tuning_buf, sizeof(tuning_buf)));
 	}
 #endif
 
 	return 0;
 }
 
-// NOTE: This is essentially the list of invalid characters in FAT32 filenames, plus '.' & ' '
+// Resolve & validate the action of a given watch, so that spawn() doesn't have to.
 static void
-    replace_invalid_chars(char* str)
+    resolve_action(uint8_t watch_idx)
 {
-	for (char* p = str; *p; p++) {
-		if (*p == '.' || *p == ' ' || *p == ':' || *p == '/' || *p == '\\' || *p == '*' || *p == '<' ||
-		    *p == '>' || *p == '"' || *p == '?' || *p == '|') {
-			*p = '_';
-		}
+	// Forget about the previous state
+	if (actionCache[watch_idx].fd != -1) {
+		close(actionCache[watch_idx].fd);
+		actionCache[watch_idx].fd = -1;
 	}
-}
+	actionCache[watch_idx].path[0] = '\0';
 
-// Implementation of Qt4's QtHash, c.f., qhash @
-// https://github.com/kovidgoyal/calibre/blob/205754891e341e7f940e70057ac3a96a2443fdbd/src/calibre/devices/kobo/driver.py#L41-L59
-static unsigned int
-    qhash(const unsigned char* restrict bytes, size_t length)
-{
-	unsigned int h = 0;
+	if (!watchConfig[watch_idx].is_active) {
+		return;
+	}
+
+	const char* action = watchConfig[watch_idx].action;
+	char        resolved[PATH_MAX];
+	if (realpath(action, resolved) == NULL) {
+		LOG(LOG_WARNING, "Cannot resolve action '%s' for watch idx %hhu: %m", action, watch_idx);
+		return;
+	}
+
+	// Peek at the header to tell scripts from binaries
+	int afd = open(resolved, O_RDONLY | O_CLOEXEC);
+	if (afd == -1) {
+		LOG(LOG_WARNING, "Cannot open action '%s' for watch idx %hhu: %m", resolved, watch_idx);
+		return;
+	}
+	struct stat st;
+	if (fstat(afd, &st) == -1 || !S_ISREG(st.st_mode)) {
+		LOG(LOG_WARNING, "Action '%s' for watch idx %hhu is not a regular file!", resolved, watch_idx);
+		close(afd);
+		return;
+	}
+	char    hdr[256] = { 0 };
+	ssize_t len      = read_in_full(afd, hdr, sizeof(hdr) - 1U);
+	close(afd);
+	if (len == -1) {
+		LOG(LOG_WARNING, "Cannot read action '%s' for watch idx %hhu: %m", resolved, watch_idx);
+		return;
+	}
+
+	if (access(resolved, X_OK) != 0) {
+		LOG(LOG_WARNING, "Action '%s' for watch idx %hhu is not executable: %m", resolved, watch_idx);
+		return;
+	}
+
+	bool is_script = (len >= 2 && hdr[0] == '#' && hdr[1] == '!');
+	bool is_elf    = (len >= 4 && memcmp(hdr, "\x7f" "ELF", 4U) == 0);
+	if (!is_script && !is_elf) {
+		// NOTE: The kernel can't exec those (ENOEXEC), so, much like execvp, spawn_child will hand them to /bin/sh.
+		LOG(LOG_NOTICE,
+		    "Action '%s' for watch idx %hhu has no shebang, it will be run through /bin/sh",
+		    resolved,
+		    watch_idx);
+	} else if (is_script) {
+		// Make sure the interpreter is actually there
+		char* interp = hdr + 2;
+		interp += strspn(interp, " \t");
+		interp[strcspn(interp, " \t\r\n")] = '\0';
+		if (interp[0] != '/' || access(interp, X_OK) != 0) {
+			LOG(LOG_WARNING,
+			    "Interpreter '%s' of action '%s' for watch idx %hhu is not usable!",
+			    interp,
+			    resolved,
+			    watch_idx);
+			FB_PRINTF("[KFMon] Bad interpreter for %s!", basename(resolved));
+			return;
+		}
+	}
+
+	str5cpy(actionCache[watch_idx].path, sizeof(actionCache[watch_idx].path), resolved, sizeof(resolved), NOTRUNC);
+
+#ifdef SYS_execveat
+	// NOTE: Scripts have to be exec'ed by path, since an O_CLOEXEC fd is gone by the time the interpreter tries to open it.
+	if (is_elf && strncmp(resolved, KFMON_TARGET_MOUNTPOINT "/", sizeof(KFMON_TARGET_MOUNTPOINT)) != 0) {
+		actionCache[watch_idx].fd = open(resolved, O_PATH | O_CLOEXEC);
+		if (actionCache[watch_idx].fd == -1) {
+			PFLOG(LOG_WARNING, "open: %m");
+		}
+	}
+#endif
+
+	DBGLOG("Resolved action '%s' for watch idx %hhu to '%s' (%s, fd: %d)",
+	       action,
+	       watch_idx,
+	       actionCache[watch_idx].path,
+	       is_elf ? "binary" : (is_script ? "script" : "shell script"),
+	       actionCache[watch_idx].fd);
+}
+
+// Resolve the actions of all our watches
+// NOTE: Called right after the watch configs have been checked for updates,
+//       which is also the only time their targets are likely to have changed (i.e., after an USBMS session).
+static void
+    resolve_actions(void)
+{
+	for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
+		resolve_action(watch_idx);
+	}
+}
+
+// NOTE: This is essentially the list of invalid characters in FAT32 filenames, plus '.' & ' '
+static void
+    replace_invalid_chars(char* str)
+{
+	for (char* p = str; *p; p++) {
+		if (*p == '.' || *p == ' ' || *p == ':' || *p == '/' || *p == '\\' || *p == '*' || *p == '<' ||
+		    *p == '>' || *p == '"' || *p == '?' || *p == '|') {
+			*p = '_';
+		}
+	}
+}
+
+// Implementation of Qt4's QtHash, c.f., qhash @
+// https://github.com/kovidgoyal/calibre/blob/205754891e341e7f940e70057ac3a96a2443fdbd/src/calibre/devices/kobo/driver.py#L41-L59
+static unsigned int
+    qhash(const unsigned char* restrict bytes, size_t length)
+{
+	unsigned int h = 0;
 
 	for (unsigned int i = 0; i < length; i++) {
 		h  = (h << 4) + bytes[i];
@@ -1246,12 +1884,29 @@ static unsigned int
 	return h;
 }
 
-// Check if our target file has been processed by Nickel...
+// Check if our target file has been processed by Nickel, keeping track of how long that took (c.f., daemonStats)
 static bool
     is_target_processed(uint8_t watch_idx, bool wait_for_db)
 {
-#ifdef DEBUG
-	// Bypass DB checks on demand for debugging purposes...
+	struct timespec t0 = { 0 };
+	clock_gettime(CLOCK_MONOTONIC_RAW, &t0);
+	bool is_processed = query_target_processed(watch_idx, wait_for_db);
+	struct timespec t1 = { 0 };
+	clock_gettime(CLOCK_MONOTONIC_RAW, &t1);
+
+	uint64_t elapsed_us = (uint64_t) ((t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_nsec - t0.tv_nsec) / 1000L);
+	update_metric_stats(&daemonStats.db_check_us, daemonStats.db_checks, elapsed_us);
+	daemonStats.db_checks++;
+
+	return is_processed;
+}
+
+// Actually check if our target file has been processed by Nickel...
+static bool
+    query_target_processed(uint8_t watch_idx, bool wait_for_db)
+{
+#if defined(DEBUG) || defined(KFMON_BENCH)
+	// Bypass DB checks on demand for debugging (or benchmarking, c.f., utils/ipc-bench.c) purposes...
 	if (watchConfig[watch_idx].skip_db_checks) {
 		return true;
 	}
@@ -1597,18 +2252,40 @@ static bool
 static void
     init_process_table(void)
 {
-	for (uint8_t i = 0U; i < WATCH_MAX; i++) {
+	for (uint8_t i = 0U; i < PT_MAX; i++) {
 		PT.spawn_pids[i]     = -1;
+		PT.spawn_gates[i]    = -1;
+		PT.spawn_states[i]   = SPAWN_RUNNING;
+		PT.spawn_srcs[i]     = NULL;
 		PT.spawn_watchids[i] = -1;
+		PT.spawn_blockers[i] = false;
+	}
+	for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
+		PT.running[watch_idx] = -1;
+		PT.standby[watch_idx] = -1;
 	}
+	PT.free_entries     = (uint32_t) ((1ULL << PT_MAX) - 1U);
+	PT.running_blockers = 0U;
 }
 
 // Returns the index of the next available entry in the process table.
 static int8_t
     get_next_available_pt_entry(void)
 {
-	for (uint8_t i = 0U; i < WATCH_MAX; i++) {
-		if (PT.spawn_watchids[i] == -1) {
+	if (PT.free_entries == 0U) {
+		return -1;
+	}
+	return (int8_t) __builtin_ctz(PT.free_entries);
+}
+
+// Returns the index of the process table entry for a given pid.
+static int8_t
+    get_pt_entry_for_pid(pid_t pid)
+{
+	// Only walk the entries in use
+	for (uint32_t used = ~PT.free_entries & (uint32_t) ((1ULL << PT_MAX) - 1U); used; used &= used - 1U) {
+		uint8_t i = (uint8_t) __builtin_ctz(used);
+		if (PT.spawn_pids[i] == pid) {
 			return (int8_t) i;
 		}
 	}
@@ -1617,18 +2294,114 @@ static int8_t
 
 // Adds information about a new spawn to the process table.
 static void
-    add_process_to_table(uint8_t i, pid_t pid, uint8_t watch_idx)
+    add_process_to_table(uint8_t i, pid_t pid, uint8_t watch_idx, SpawnState state)
 {
 	PT.spawn_pids[i]     = pid;
+	PT.spawn_gates[i]    = -1;
+	PT.spawn_states[i]   = SPAWN_DISARMED;
+	PT.spawn_srcs[i]     = NULL;
 	PT.spawn_watchids[i] = (int8_t) watch_idx;
+	PT.spawn_blockers[i] = false;
+	PT.spawn_exec_us[i]  = 0L;
+	PT.free_entries &= ~(1U << i);
+
+	set_process_state(i, state);
+}
+
+// Moves a process table entry to a new state, and updates the per-watch lookups accordingly.
+static void
+    set_process_state(uint8_t i, SpawnState state)
+{
+	uint8_t watch_idx = (uint8_t) PT.spawn_watchids[i];
+	statePage.dirty   = true;
+
+	// Leave the previous state...
+	switch (PT.spawn_states[i]) {
+		case SPAWN_RUNNING:
+			PT.running[watch_idx] = -1;
+			if (PT.spawn_blockers[i]) {
+				PT.spawn_blockers[i] = false;
+				if (--PT.running_blockers == 0U) {
+					NOTIFY_SUBSCRIBERS("unblocked");
+				}
+			}
+			break;
+		case SPAWN_STANDBY:
+			PT.standby[watch_idx] = -1;
+			break;
+		case SPAWN_DISARMED:
+		default:
+			break;
+	}
+
+	// ...and enter the new one.
+	PT.spawn_states[i] = state;
+	switch (state) {
+		case SPAWN_RUNNING:
+			PT.running[watch_idx] = (int8_t) i;
+			clock_gettime(CLOCK_MONOTONIC_RAW, &PT.spawn_starts[i]);
+			spawnStats[watch_idx].last_launch = time(NULL);
+			NOTIFY_SUBSCRIBERS("spawned:%hhu:%ld", watch_idx, (long) PT.spawn_pids[i]);
+			if (watchConfig[watch_idx].block_spawns) {
+				PT.spawn_blockers[i] = true;
+				if (PT.running_blockers++ == 0U) {
+					NOTIFY_SUBSCRIBERS("blocked");
+				}
+			}
+			break;
+		case SPAWN_STANDBY:
+			PT.standby[watch_idx] = (int8_t) i;
+			break;
+		case SPAWN_DISARMED:
+		default:
+			break;
+	}
 }
 
 // Removes information about a spawn from the process table.
 static void
     remove_process_from_table(uint8_t i)
 {
+	// Close our end of its gate, if it was a standby that never got released
+	if (PT.spawn_gates[i] != -1) {
+		close(PT.spawn_gates[i]);
+	}
+
+	// Drop it from the per-watch lookups
+	set_process_state(i, SPAWN_DISARMED);
+
 	PT.spawn_pids[i]     = -1;
+	PT.spawn_gates[i]    = -1;
+	PT.spawn_states[i]   = SPAWN_RUNNING;
+	PT.spawn_srcs[i]     = NULL;
 	PT.spawn_watchids[i] = -1;
+	PT.free_entries |= (1U << i);
+}
+
+// Re-account for running spawn blockers, as a config update may have (un)flagged a watch as such.
+static void
+    refresh_blockers(void)
+{
+	bool was_blocked    = PT.running_blockers > 0U;
+	PT.running_blockers = 0U;
+	statePage.dirty     = true;
+	for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
+		int8_t i = PT.running[watch_idx];
+		if (i < 0) {
+			continue;
+		}
+
+		// NOTE: A watch dropped while running keeps blocking until it's reaped (c.f., WatchConfig.pending_release).
+		PT.spawn_blockers[i] = (watchConfig[watch_idx].is_active || watchConfig[watch_idx].pending_release) &&
+				       watchConfig[watch_idx].block_spawns;
+		if (PT.spawn_blockers[i]) {
+			PT.running_blockers++;
+		}
+	}
+
+	if (was_blocked != (PT.running_blockers > 0U)) {
+		NOTIFY_SUBSCRIBERS("%s", was_blocked ? "unblocked" : "blocked");
+	}
 }
 
 // Initializes the FBInk config
@@ -1650,359 +2423,1638 @@ static void
 	fbinkConfig.wfm_mode = WFM_DU;
 }
 
-// Wait for a specific child process to die, and reap it (runs in a dedicated thread per spawn).
-static void*
-    reaper_thread(void* ptr)
-{
-	uint8_t i = *((uint8_t*) ptr);
-
-	pid_t tid = (pid_t) syscall(SYS_gettid);
-
-	pid_t   cpid;
-	uint8_t watch_idx;
-	pthread_mutex_lock(&ptlock);
-	cpid      = PT.spawn_pids[i];
-	watch_idx = (uint8_t) PT.spawn_watchids[i];
-	pthread_mutex_unlock(&ptlock);
-
-	// Storage needed for get_current_time_r
-	struct tm local_tm;
-	char      sz_time[22];
-
-	// Remember the current time for the execvp errno/exitcode heuristic...
-	struct timespec then = { 0 };
-	clock_gettime(CLOCK_MONOTONIC_RAW, &then);
-
-	MTLOG(LOG_INFO,
-	      "[%s] [INFO] [TID: %ld] Waiting to reap process %ld (from watch idx %hhu) . . .",
-	      get_current_time_r(&local_tm, sz_time, sizeof(sz_time)),
-	      (long) tid,
-	      (long) cpid,
-	      watch_idx);
-	pid_t ret;
-	int   wstatus;
-	// Wait for our child process to terminate, retrying on EINTR
-	// NOTE: This is quite likely overkill on Linux (c.f., https://stackoverflow.com/a/59795677)
-	do {
-		ret = waitpid(cpid, &wstatus, 0);
-	} while (ret == -1 && errno == EINTR);
-	// Recap what happened to it
-	if (ret != cpid) {
-		PFMTLOG(LOG_CRIT, "waitpid: %m");
-		free(ptr);
-		return (void*) NULL;
-	} else {
-		if (WIFEXITED(wstatus)) {
-			int exitcode = WEXITSTATUS(wstatus);
-			MTLOG(
-			    LOG_NOTICE,
-			    "[%s] [NOTE] [TID: %ld] Reaped process %ld (from watch idx %hhu): It exited with status %d.",
-			    get_current_time_r(&local_tm, sz_time, sizeof(sz_time)),
-			    (long) tid,
-			    (long) cpid,
-			    watch_idx,
-			    exitcode);
-			// NOTE: Ugly hack to try to salvage execvp's potential error...
-			//       If the process exited with a non-zero status code,
-			//       within (roughly) a second of being launched,
-			//       assume the exit code is actually inherited from execvp's errno...
-			struct timespec now = { 0 };
-			clock_gettime(CLOCK_MONOTONIC_RAW, &now);
-			// NOTE: We should be okay not using difftime on Linux (We're using a monotonic clock, time_t is int64_t).
-			if (exitcode != 0 && (now.tv_sec - then.tv_sec) <= 1) {
-				char        buf[256];
-				// NOTE: We *know* we'll be using the GNU, glibc >= 2.13 version of strerror_r
-				// NOTE: Even if it's not entirely clear from the manpage, printf's %m *is* thread-safe,
-				//       c.f., stdio-common/vfprintf.c:962 (it's using strerror_r).
-				//       But since we're not checking errno but a custom variable, do it the hard way :)
-				const char* sz_error = strerror_r(exitcode, buf, sizeof(buf));
-				MTLOG(
-				    LOG_CRIT,
-				    "[%s] [CRIT] [TID: %ld] If nothing was visibly launched, and/or especially if status > 1, this *may* actually be an execvp() error: %s.",
-				    get_current_time_r(&local_tm, sz_time, sizeof(sz_time)),
-				    (long) tid,
-				    sz_error);
-				FB_PRINTF("[KFMon] PID %ld exited unexpectedly: %d!", (long) cpid, exitcode);
-			}
-		} else if (WIFSIGNALED(wstatus)) {
-			// NOTE: strsignal is not thread safe... Use psignal instead.
-			int  sigcode = WTERMSIG(wstatus);
-			char buf[256];
-			snprintf(
-			    buf,
-			    sizeof(buf),
-			    "[KFMon] [%s] [WARN] [TID: %ld] Reaped process %ld (from watch idx %hhu): It was killed by signal %d",
-			    get_current_time_r(&local_tm, sz_time, sizeof(sz_time)),
-			    (long) tid,
-			    (long) cpid,
-			    watch_idx,
-			    sigcode);
-			FB_PRINTF("[KFMon] PID %ld was killed by signal %d!", (long) cpid, sigcode);
-			if (daemonConfig.use_syslog) {
-				// NOTE: No strsignal means no human-readable interpretation of the signal w/ syslog
-				//       (the %m token only works for errno)...
-				syslog(LOG_NOTICE, "%s", buf);
-			} else {
-				psignal(sigcode, buf);
-			}
+// Check whether the fb's var/fix screeninfo changed since our last snapshot (updating said snapshot in the process).
+// NOTE: That's only two ioctls on an fd we keep around, which is much cheaper than a full fbink_reinit.
+//       If we can't query the fb ourselves for some reason, always assume it changed, to be safe.
+static bool
+    has_fb_state_changed(void)
+{
+	if (fbSnapshot.fbfd == -1) {
+		fbSnapshot.fbfd = open("/dev/fb0", O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+		if (fbSnapshot.fbfd == -1) {
+			return true;
 		}
 	}
 
-	// And now we can safely remove it from the process table
-	pthread_mutex_lock(&ptlock);
-	remove_process_from_table(i);
-	pthread_mutex_unlock(&ptlock);
+	struct fb_var_screeninfo vinfo;
+	struct fb_fix_screeninfo finfo;
+	if (ioctl(fbSnapshot.fbfd, FBIOGET_VSCREENINFO, &vinfo) == -1) {
+		PFLOG(LOG_WARNING, "FBIOGET_VSCREENINFO: %m");
+		return true;
+	}
+	if (ioctl(fbSnapshot.fbfd, FBIOGET_FSCREENINFO, &finfo) == -1) {
+		PFLOG(LOG_WARNING, "FBIOGET_FSCREENINFO: %m");
+		return true;
+	}
 
-	free(ptr);
+	bool changed = (memcmp(&vinfo, &fbSnapshot.vinfo, sizeof(vinfo)) != 0) ||
+		       (memcmp(&finfo, &fbSnapshot.finfo, sizeof(finfo)) != 0);
+	if (changed) {
+		fbSnapshot.vinfo = vinfo;
+		fbSnapshot.finfo = finfo;
+	}
 
-	return (void*) NULL;
+	return changed;
 }
 
-// Spawn a process and return its pid...
-// Initially inspired from popen2() implementations from https://stackoverflow.com/questions/548063
-// As well as the glibc's system() call,
-// With a bit of added tracking to handle reaping without a SIGCHLD handler.
-static pid_t
-    spawn(char* const* command, uint8_t watch_idx)
+// Make sure FBInk has an up-to-date fb state, right before we print something (main thread only).
+// NOTE: Because the framebuffer state is liable to have changed since our last init/reinit,
+//       either expectedly (boot -> pickel -> nickel), or a bit more unpredictably (rotation, bitdepth change),
+//       we need FBInk to have an up-to-date fb state whenever we print something,
+//       so that messages will be printed properly, no matter what :).
+// NOTE: Even forgetting about rotation and bitdepth changes, which may not ever happen on most *vanilla* devices,
+//       this is needed because processing is done very early by Nickel for "new" icons,
+//       when they end up on the Home screen straight away,
+//       (which is a given if you added at most 3 items, with the new Home screen).
+//       Not doing a reinit would be problematic, because it's early enough that pickel is still running,
+//       so we'd be inheriting its quirky fb setup and not Nickel's...
+// NOTE: We used to do this unconditionally for each batch of inotify events, each IPC connection,
+//       and each iteration of the main loop, even though most of those never end up printing anything.
+//       Now we only do it on demand, and we skip it entirely if the fb's screeninfo didn't budge.
+static void
+    refresh_fbink_state(void)
 {
-	pid_t pid = fork();
-
-	if (pid < 0) {
-		// Fork failed?
-		PFLOG(LOG_ERR, "Aborting: fork: %m");
-		FB_PRINT("[KFMon] fork failed ?!");
-		exit(EXIT_FAILURE);
-	} else if (pid == 0) {
-		// Sweet child o' mine!
-		// NOTE: We're multithreaded & forking, this means that from this point on until execve(),
-		//       we can only use async-safe functions!
-		//       See pthread_atfork(3) for details.
-		// Do the whole stdin/stdout/stderr dance again,
-		// to ensure that child process doesn't inherit our tweaked fds...
-		dup2(origStdin, fileno(stdin));
-		dup2(origStdout, fileno(stdout));
-		dup2(origStderr, fileno(stderr));
-		close(origStdin);
-		close(origStdout);
-		close(origStderr);
-		// Restore signals
-		struct sigaction sa = { .sa_handler = SIG_DFL, .sa_flags = SA_RESTART };
-		sigaction(SIGHUP, &sa, NULL);
-		// NOTE: We used to use execvpe when being launched from udev,
-		//       in order to sanitize all the crap we inherited from udev's env ;).
-		//       Now, we actually rely on the specific env we inherit from rcS/on-animator!
-		execvp(*command, command);
-		// NOTE: This will only ever be reached on error, hence the lack of actual return value check ;).
-		//       Resort to an ugly hack by exiting with execvp()'s errno,
-		//       which we can then try to salvage in the reaper thread.
-		exit(errno);
-	} else {
-		// Parent
-		// Keep track of the process
-		int8_t i;
-		pthread_mutex_lock(&ptlock);
-		i = get_next_available_pt_entry();
-		pthread_mutex_unlock(&ptlock);
+	// NOTE: On sunxi, the rotation is tracked by FBInk itself (via the gyro or the working buffer),
+	//       and the fb's screeninfo is meaningless, so always let FBInk figure it out.
+	if (!fbinkState.is_sunxi && !has_fb_state_changed()) {
+		return;
+	}
 
-		if (i < 0) {
-			// NOTE: If we ever hit this error codepath,
-			//       we don't have to worry about leaving that last spawn as a zombie:
-			//       One of the benefits of the double-fork we do to daemonize is that, on our death,
-			//       our children will get reparented to init, which, by design,
-			//       will handle the reaping automatically.
-			LOG(LOG_ERR,
-			    "Failed to find an available entry in our process table for pid %ld, aborting!",
-			    (long) pid);
-			FB_PRINT("[KFMon] Can't spawn any more processes!");
-			exit(EXIT_FAILURE);
-		} else {
-			pthread_mutex_lock(&ptlock);
-			add_process_to_table((uint8_t) i, pid, watch_idx);
-			pthread_mutex_unlock(&ptlock);
-
-			DBGLOG("Assigned pid %ld (from watch idx %hhu) to process table entry idx %hhd",
-			       (long) pid,
-			       watch_idx,
-			       i);
-			// NOTE: We can't do that from the child proper, because it's not async-safe,
-			//       so do it from here.
-			LOG(LOG_NOTICE,
-			    "Spawned process %ld (%s -> %s @ watch idx %hhu) . . .",
-			    (long) pid,
-			    watchConfig[watch_idx].filename,
-			    watchConfig[watch_idx].action,
-			    watch_idx);
-			if (daemonConfig.with_notifications) {
-				FB_PRINTF("[KFMon] Launched %s :)", basename(watchConfig[watch_idx].action));
-			}
-			// NOTE: We achieve reaping in a non-blocking way by doing the reaping from a dedicated thread
-			//       for every spawn...
-			//       See #2 for an history of the previous failed attempts...
-			pthread_t rthread;
-			uint8_t*  arg = malloc(sizeof(*arg));
-			if (arg == NULL) {
-				LOG(LOG_ERR, "Couldn't allocate memory for thread arg, aborting!");
-				FB_PRINT("[KFMon] OOM ?!");
-				exit(EXIT_FAILURE);
-			}
-			*arg = (uint8_t) i;
+	if (unlikely(fbink_reinit(FBFD_AUTO, &fbinkConfig) < 0)) {
+		PFLOG(LOG_WARNING, "fbink_reinit: failure");
+	}
+}
 
-			// NOTE: We will *never* wait for one of these threads to die from the main thread, so,
-			//       start them in detached state
-			//       to make sure their resources will be released when they terminate.
-			pthread_attr_t attr;
-			if (pthread_attr_init(&attr) != 0) {
-				PFLOG(LOG_ERR, "Aborting: pthread_attr_init: %m");
-				FB_PRINT("[KFMon] pthread_attr_init failed ?!");
-				exit(EXIT_FAILURE);
-			}
-			if (pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED) != 0) {
-				PFLOG(LOG_ERR, "Aborting: pthread_attr_setdetachstate: %m");
-				FB_PRINT("[KFMon] pthread_attr_setdetachstate failed ?!");
-				exit(EXIT_FAILURE);
-			}
+// Thin wrapper around the pidfd_open syscall
+static int
+    sys_pidfd_open(pid_t pid, unsigned int flags)
+{
+	return (int) syscall(SYS_pidfd_open, pid, flags);
+}
 
-			// NOTE: Use a smaller stack (ulimit -s is 8MB on the Kobos).
-			//       Base it on pointer size, aiming for 1MB on x64 (meaning 512KB on x86/arm).
-			//       Floor it at 512KB to be safe, though.
-			//       In the grand scheme of things, this won't really change much ;).
-			if (pthread_attr_setstacksize(
-				&attr, MAX((1U * 1024U * 1024U) / 2U, (sizeof(void*) * 1024U * 1024U) / 8U)) != 0) {
-				PFLOG(LOG_ERR, "Aborting: pthread_attr_setstacksize: %m");
-				FB_PRINT("[KFMon] pthread_attr_setstacksize failed ?!");
-				exit(EXIT_FAILURE);
-			}
-			if (pthread_create(&rthread, &attr, reaper_thread, arg) != 0) {
-				PFLOG(LOG_ERR, "Aborting: pthread_create: %m");
-				FB_PRINT("[KFMon] pthread_create failed ?!");
-				exit(EXIT_FAILURE);
-			}
+// Figure out how we'll be notified of our children's demise, and set it up.
+// NOTE: We used to spawn a dedicated thread per child, which just sat in a blocking waitpid (c.f., #2 for the history
+//       of previous failed attempts w/ a SIGCHLD handler).
+//       Now, the main loop takes care of it: either via a pidfd per child (Linux 5.3+),
+//       or, on older kernels, via a signalfd catching SIGCHLD, in which case we reap everything that's ready.
+//       With a spawn helper, our actions are its children, so it reaps them, and just lets us know.
+static int
+    init_reaper(void)
+{
+#ifdef KFMON_SPAWN_HELPER
+	reaper.helper_src = reactor_add(spawnHelper.exit_fd, EPOLLIN, on_spawn_helper_event, NULL);
+	if (reaper.helper_src == NULL) {
+		return -1;
+	}
+	LOG(LOG_INFO, "Children will be tracked via our spawn helper");
 
-			// Prettify the thread's name. Must be <= 15 characters long (i.e., 16 bytes, NULL included).
-			char thname[16];
-			snprintf(thname, sizeof(thname), "Reap:%ld", (long) pid);
-			if (pthread_setname_np(rthread, thname) != 0) {
-				PFLOG(LOG_ERR, "Aborting: pthread_setname_np: %m");
-				FB_PRINT("[KFMon] pthread_setname_np failed ?!");
-				exit(EXIT_FAILURE);
-			}
+	return 0;
+#endif
 
-			if (pthread_attr_destroy(&attr) != 0) {
-				PFLOG(LOG_ERR, "Aborting: pthread_attr_destroy: %m");
-				FB_PRINT("[KFMon] pthread_attr_destroy failed ?!");
-				exit(EXIT_FAILURE);
-			}
-		}
+	// Check if the kernel supports pidfds by trying to get one for ourselves.
+	int pidfd = sys_pidfd_open(getpid(), 0U);
+	if (pidfd != -1) {
+		close(pidfd);
+		reaper.use_pidfd = true;
+		LOG(LOG_INFO, "Children will be tracked via pidfds");
+		return 0;
 	}
+	DBGLOG("pidfd_open: %m");
+
+	// NOTE: SIGCHLD needs to be blocked for the signalfd to pick it up.
+	//       We're not multi-threaded, and it's restored to our children in spawn().
+	sigset_t mask;
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGCHLD);
+	if (sigprocmask(SIG_BLOCK, &mask, NULL) == -1) {
+		PFLOG(LOG_ERR, "sigprocmask: %m");
+		return -1;
+	}
+	int sfd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+	if (sfd == -1) {
+		PFLOG(LOG_ERR, "signalfd: %m");
+		return -1;
+	}
+	reaper.sigchld_src = reactor_add(sfd, EPOLLIN, on_sigchld_event, NULL);
+	if (reaper.sigchld_src == NULL) {
+		close(sfd);
+		return -1;
+	}
+	reaper.use_pidfd = false;
+	LOG(LOG_INFO, "Children will be tracked via SIGCHLD");
 
-	return pid;
+	return 0;
 }
 
-// Check if a given inotify watch already has a spawn running
-static bool
-    is_watch_already_spawned(uint8_t watch_idx)
+// Register the process at entry i of the process table with the main loop, if it needs to be.
+static void
+    track_process(uint8_t i)
 {
-	// Walk our process table to see if the given watch currently has a registered running process
-	for (uint8_t i = 0U; i < WATCH_MAX; i++) {
-		if (PT.spawn_watchids[i] == (int8_t) watch_idx) {
-			return true;
-			// NOTE: Assume everything's peachy,
-			//       and we'll never end up with the same watch_idx assigned to multiple indices in the
-			//       process table.
-		}
+	// With a signalfd, SIGCHLD already has us covered (as does our spawn helper, if any).
+	if (!reaper.use_pidfd) {
+		return;
 	}
 
-	return false;
+	int pidfd = sys_pidfd_open(PT.spawn_pids[i], 0U);
+	if (pidfd == -1) {
+		PFLOG(LOG_ERR, "Aborting: pidfd_open: %m");
+		FB_PRINT("[KFMon] pidfd_open failed ?!");
+		exit(EXIT_FAILURE);
+	}
+	PT.spawn_srcs[i] = reactor_add(pidfd, EPOLLIN, on_pidfd_event, (void*) (uintptr_t) i);
+	if (PT.spawn_srcs[i] == NULL) {
+		LOG(LOG_ERR, "Failed to register pid %ld with the event loop, aborting!", (long) PT.spawn_pids[i]);
+		FB_PRINT("[KFMon] Can't track spawned process!");
+		exit(EXIT_FAILURE);
+	}
 }
 
-// Check if a watch flagged as a spawn blocker (e.g., KOReader or Plato) is already running
-// NOTE: This is mainly to prevent spurious spawns that might be unwittingly caused by their file manager
-//       (be it through metadata reading, thumbnails creation, or whatever).
-//       Another workaround is of course to kill KFMon as part of their startup process...
-static bool
-    is_blocker_running(void)
+// Recap what happened to the (already reaped) process at entry i of the process table, and release said entry.
+static void
+    reap_process(uint8_t i, int wstatus, const struct rusage* ru)
 {
-	// Walk our process table to identify watches with a currently running process
-	for (uint8_t i = 0U; i < WATCH_MAX; i++) {
-		if (PT.spawn_watchids[i] != -1) {
-			// Walk the active watch list to match that currently running watch to its block_spawns flag
-			for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
-				if (!watchConfig[watch_idx].is_active) {
-					continue;
-				}
+	pid_t      cpid      = PT.spawn_pids[i];
+	uint8_t    watch_idx = (uint8_t) PT.spawn_watchids[i];
+	SpawnState state     = PT.spawn_states[i];
 
-				if (PT.spawn_watchids[i] == (int8_t) watch_idx) {
-					if (watchConfig[watch_idx].block_spawns) {
-						return true;
-					}
-				}
-			}
+	if (WIFEXITED(wstatus)) {
+		int exitcode = WEXITSTATUS(wstatus);
+		LOG(LOG_NOTICE,
+		    "Reaped process %ld (from watch idx %hhu): It exited with status %d.",
+		    (long) cpid,
+		    watch_idx,
+		    exitcode);
+		if (state == SPAWN_RUNNING) {
+			NOTIFY_SUBSCRIBERS("exited:%hhu:%ld:%d", watch_idx, (long) cpid, exitcode);
+		}
+	} else if (WIFSIGNALED(wstatus)) {
+		int sigcode = WTERMSIG(wstatus);
+		LOG(LOG_WARNING,
+		    "Reaped process %ld (from watch idx %hhu): It was killed by signal %d (%s).",
+		    (long) cpid,
+		    watch_idx,
+		    sigcode,
+		    strsignal(sigcode));
+		FB_PRINTF("[KFMon] PID %ld was killed by signal %d!", (long) cpid, sigcode);
+		if (state == SPAWN_RUNNING) {
+			NOTIFY_SUBSCRIBERS("killed:%hhu:%ld:%d", watch_idx, (long) cpid, sigcode);
 		}
 	}
 
-	// Nothing currently running is a spawn blocker, we're good to go!
-	return false;
+	// Only account for the runs that were actually triggered (i.e., not standbys that never got released)
+	if (state == SPAWN_RUNNING) {
+		account_process(watch_idx, PT.spawn_exec_us[i], &PT.spawn_starts[i], ru);
+		spawnStats[watch_idx].last_wstatus = wstatus;
+		spawnStats[watch_idx].has_exited   = true;
+	}
+
+	// Forget about its pidfd, if any
+	if (PT.spawn_srcs[i]) {
+		int pidfd = PT.spawn_srcs[i]->fd;
+		reactor_del(PT.spawn_srcs[i]);
+		close(pidfd);
+	}
+
+	// And now we can safely remove it from the process table
+	remove_process_from_table(i);
+
+	// If its watch was dropped in the meantime, its slot is finally up for grabs
+	if (watchConfig[watch_idx].pending_release && !is_watch_already_spawned(watch_idx)) {
+		release_watch_slot(watch_idx);
+	}
+
+	// If that was the last spawn blocker, get back to work
+	if (quiescence.active && state == SPAWN_RUNNING) {
+		update_quiescent_mode();
+	}
+
+	// Re-arm standby watches once their action is done
+	if (state == SPAWN_STANDBY) {
+		// NOTE: Don't try again if it died before we even released it, we'd just end up in a spawn loop.
+		LOG(LOG_WARNING,
+		    "The standby process for watch idx %hhu exited before being released, it won't be re-armed until the next config reload",
+		    watch_idx);
+	} else if (state == SPAWN_RUNNING && watchConfig[watch_idx].is_active && watchConfig[watch_idx].standby) {
+		arm_standby(watch_idx);
+	}
 }
 
-// Check if spawns are inhibited by the global block file
-static bool
-    are_spawns_blocked(void)
+// Reactor callback for a child's pidfd, which becomes readable when said child dies.
+static void
+    on_pidfd_event(ReactorSource* src, uint32_t events __attribute__((unused)))
 {
-	const char block_path[] = KFMON_CONFIGPATH "/BLOCK";
-	if (access(block_path, F_OK) == 0) {
-		// Global block file is here, prevent new spawns...
-		return true;
+	uint8_t i    = (uint8_t) (uintptr_t) src->data;
+	pid_t   cpid = PT.spawn_pids[i];
+
+	int           wstatus;
+	struct rusage ru;
+	pid_t         ret = wait4(cpid, &wstatus, WNOHANG, &ru);
+	if (ret == cpid) {
+		reap_process(i, wstatus, &ru);
+	} else if (ret == -1) {
+		PFLOG(LOG_CRIT, "wait4: %m");
 	}
-
-	return false;
 }
 
-// Return the pid of the spawn of a given inotify watch
-static pid_t
-    get_spawn_pid_for_watch(uint8_t watch_idx)
+// Reactor callback for our SIGCHLD signalfd: reap every child that's ready.
+static void
+    on_sigchld_event(ReactorSource* src, uint32_t events __attribute__((unused)))
 {
-	for (uint8_t i = 0U; i < WATCH_MAX; i++) {
-		if (PT.spawn_watchids[i] == (int8_t) watch_idx) {
-			return PT.spawn_pids[i];
-		}
+	// Drain the signalfd (standard signals are coalesced, so there's no 1:1 mapping to children anyway).
+	struct signalfd_siginfo fdsi;
+	while (read(src->fd, &fdsi, sizeof(fdsi)) == sizeof(fdsi)) {
+		;
 	}
 
-	return -1;
+	// And reap everything that's ready, in a non-blocking manner.
+	int           wstatus;
+	struct rusage ru;
+	pid_t         cpid;
+	while ((cpid = wait4(-1, &wstatus, WNOHANG, &ru)) > 0) {
+		int8_t i = get_pt_entry_for_pid(cpid);
+		if (i < 0) {
+			LOG(LOG_WARNING, "Reaped unknown process %ld", (long) cpid);
+			continue;
+		}
+		reap_process((uint8_t) i, wstatus, &ru);
+	}
+	if (cpid == -1 && errno != ECHILD) {
+		PFLOG(LOG_CRIT, "wait4: %m");
+	}
 }
 
-// Read all available inotify events from the file descriptor 'fd' (caller breaks on true).
-static bool
-    handle_events(int fd)
+// Record the resource usage of a reaped process in its watch's stats
+static void
+    account_process(uint8_t watch_idx, long int exec_us, const struct timespec* start, const struct rusage* ru)
 {
-	// NOTE: Because the framebuffer state is liable to have changed since our last init/reinit,
-	//       either expectedly (boot -> pickel -> nickel), or a bit more unpredictably (rotation, bitdepth change),
-	//       we'll ask FBInk to make sure it has an up-to-date fb state for each new batch of events,
-	//       so that messages will be printed properly, no matter what :).
-	//       Put everything behind our mutex to be super-safe,
-	//       since we're playing with library globals...
-	// NOTE: Even forgetting about rotation and bitdepth changes, which may not ever happen on most *vanilla* devices,
-	//       this is needed because processing is done very early by Nickel for "new" icons,
-	//       when they end up on the Home screen straight away,
-	//       (which is a given if you added at most 3 items, with the new Home screen).
-	//       Not doing a reinit would be problematic, because it's early enough that pickel is still running,
-	//       so we'd be inheriting its quirky fb setup and not Nickel's...
-	// NOTE: This was moved from inside the following loop to here, just outside of it, in order to limit locking,
-	//       but it will in fact change nothing if events aren't actually batched,
-	//       which appears to be the case in most of our use-cases...
-	pthread_mutex_lock(&ptlock);
-	if (unlikely(fbink_reinit(FBFD_AUTO, &fbinkConfig) < 0)) {
-		PFLOG(LOG_WARNING, "fbink_reinit: failure");
+	struct timespec now = { 0 };
+	clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+
+	uint64_t sample[METRIC_COUNT];
+	sample[METRIC_WALL_MS] =
+	    (uint64_t) ((now.tv_sec - start->tv_sec) * 1000L + (now.tv_nsec - start->tv_nsec) / 1000000L);
+	sample[METRIC_EXEC_US]   = (uint64_t) exec_us;
+	sample[METRIC_UTIME_MS]  = (uint64_t) (ru->ru_utime.tv_sec * 1000L + ru->ru_utime.tv_usec / 1000L);
+	sample[METRIC_STIME_MS]  = (uint64_t) (ru->ru_stime.tv_sec * 1000L + ru->ru_stime.tv_usec / 1000L);
+	// NOTE: Linux reports it in KB
+	sample[METRIC_MAXRSS_KB] = (uint64_t) ru->ru_maxrss;
+	sample[METRIC_MAJFLT]    = (uint64_t) ru->ru_majflt;
+	sample[METRIC_INBLOCK]   = (uint64_t) ru->ru_inblock;
+	sample[METRIC_OUBLOCK]   = (uint64_t) ru->ru_oublock;
+
+	LOG(LOG_INFO,
+	    "Resource usage for watch idx %hhu: wall=%llums, exec=%lluus, user=%llums, sys=%llums, maxrss=%lluKB, majflt=%llu, inblock=%llu, oublock=%llu",
+	    watch_idx,
+	    (unsigned long long int) sample[METRIC_WALL_MS],
+	    (unsigned long long int) sample[METRIC_EXEC_US],
+	    (unsigned long long int) sample[METRIC_UTIME_MS],
+	    (unsigned long long int) sample[METRIC_STIME_MS],
+	    (unsigned long long int) sample[METRIC_MAXRSS_KB],
+	    (unsigned long long int) sample[METRIC_MAJFLT],
+	    (unsigned long long int) sample[METRIC_INBLOCK],
+	    (unsigned long long int) sample[METRIC_OUBLOCK]);
+
+	SpawnStats* stats = &spawnStats[watch_idx];
+	for (uint8_t m = 0U; m < METRIC_COUNT; m++) {
+		update_metric_stats(&stats->metrics[m], stats->runs, sample[m]);
 	}
-	pthread_mutex_unlock(&ptlock);
+	stats->runs++;
+}
 
-	// Some systems cannot read integer variables if they are not properly aligned.
-	// On other systems, incorrect alignment may decrease performance.
-	// Hence, the buffer used for reading from the inotify file descriptor
-	// should have the same alignment as struct inotify_event.
-	char                        buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
-	const struct inotify_event* event;
-	bool                        destroyed_wd  = false;
-	bool                        was_unmounted = false;
+// Account for a new sample of a metric, count being the amount of samples it has already seen.
+static void
+    update_metric_stats(MetricStats* ms, uint32_t count, uint64_t sample)
+{
+	ms->last = sample;
+	if (count == 0U || sample < ms->min) {
+		ms->min = sample;
+	}
+	if (count == 0U || sample > ms->max) {
+		ms->max = sample;
+	}
+	ms->sum += sample;
+}
+
+// Format the stats of a given watch as a single line, for IPC (id:basename(filename):runs=N metric=last/min/max/mean ...).
+// Returns the amount of characters printed (c.f., snprintf).
+static int
+    format_spawn_stats(uint8_t watch_idx, char* buf, size_t size)
+{
+	const SpawnStats* stats = &spawnStats[watch_idx];
+	int               len   = snprintf(
+		    buf, size, "%hhu:%s:runs=%u", watch_idx, basename(watchConfig[watch_idx].filename), stats->runs);
+	for (uint8_t m = 0U; stats->runs > 0U && m < METRIC_COUNT && len > 0 && (size_t) len < size; m++) {
+		const MetricStats* ms = &stats->metrics[m];
+		len += snprintf(buf + len,
+				size - (size_t) len,
+				" %s=%llu/%llu/%llu/%llu",
+				spawn_metric_names[m],
+				(unsigned long long int) ms->last,
+				(unsigned long long int) ms->min,
+				(unsigned long long int) ms->max,
+				(unsigned long long int) (ms->sum / stats->runs));
+	}
+	if (len < 0) {
+		return len;
+	}
+	// Make sure we always end with a LF, even if we had to truncate
+	if ((size_t) len > size - 2U) {
+		len = (int) size - 2;
+	}
+	buf[len++] = '\n';
+	buf[len]   = '\0';
+
+	return len;
+}
+
+// Format the daemon-wide status as a single line, for IPC
+// (daemon:uptime_s=N events=N db_checks=N db_check_us=last/min/max/mean rebuilds=N ipc_clients=N ipc_requests=N
+//  prefetch_lock=acquired/contended).
+// Returns the amount of characters printed (c.f., snprintf).
+static int
+    format_daemon_status(char* buf, size_t size)
+{
+	const MetricStats* db = &daemonStats.db_check_us;
+	// NOTE: The prefetch thread updates these with the lock held, so don't count ourselves in.
+	pthread_mutex_lock(&prefetcher.lock.mutex);
+	unsigned long int acquired  = prefetcher.lock.acquired;
+	unsigned long int contended = prefetcher.lock.contended;
+	pthread_mutex_unlock(&prefetcher.lock.mutex);
+	return snprintf(buf,
+			size,
+			"daemon:uptime_s=%ld events=%llu db_checks=%u db_check_us=%llu/%llu/%llu/%llu rebuilds=%u ipc_clients=%llu ipc_requests=%llu prefetch_lock=%lu/%lu\n",
+			(get_monotonic_ms() - daemonStats.start_ms) / 1000L,
+			(unsigned long long int) daemonStats.events,
+			daemonStats.db_checks,
+			(unsigned long long int) db->last,
+			(unsigned long long int) db->min,
+			(unsigned long long int) db->max,
+			(unsigned long long int) (daemonStats.db_checks ? db->sum / daemonStats.db_checks : 0U),
+			daemonStats.rebuilds,
+			(unsigned long long int) daemonStats.ipc_clients,
+			(unsigned long long int) daemonStats.ipc_requests,
+			acquired,
+			contended);
+}
+
+// Format the status of a given watch slot as a single line, for IPC
+// (id:basename(filename):active=B armed=B pending_processing=B processing_ts=N pid=N last_exit=X last_launch=N
+//  spawn_failures=N last_spawn_errno=N).
+// Returns the amount of characters printed (c.f., snprintf).
+static int
+    format_watch_status(uint8_t watch_idx, char* buf, size_t size)
+{
+	const WatchConfig* watch = &watchConfig[watch_idx];
+	const SpawnStats*  stats = &spawnStats[watch_idx];
+
+	// Either none, exit:status or signal:signum
+	char last_exit[32] = "none";
+	if (stats->has_exited) {
+		if (WIFSIGNALED(stats->last_wstatus)) {
+			snprintf(last_exit, sizeof(last_exit), "signal:%d", WTERMSIG(stats->last_wstatus));
+		} else {
+			snprintf(last_exit, sizeof(last_exit), "exit:%d", WEXITSTATUS(stats->last_wstatus));
+		}
+	}
+
+	return snprintf(
+	    buf,
+	    size,
+	    "%hhu:%s:active=%d armed=%d pending_processing=%d processing_ts=%lld pid=%ld last_exit=%s last_launch=%lld spawn_failures=%u last_spawn_errno=%d\n",
+	    watch_idx,
+	    watch->is_active ? basename(watch->filename) : "",
+	    watch->is_active,
+	    watch->is_active && watch->inotify_wd != -1,
+	    watch->pending_processing,
+	    (long long int) watch->processing_ts,
+	    (long) get_spawn_pid_for_watch(watch_idx),
+	    last_exit,
+	    (long long int) stats->last_launch,
+	    stats->spawn_failures,
+	    stats->last_spawn_errno);
+}
+
+// Create & map the state page (c.f., utils/state_page.h). Not fatal, frontends can always fall back to IPC.
+static void
+    init_state_page(void)
+{
+	// NOTE: Readers may still have the page of a previous instance mapped, and rewriting that one in place
+	//       (let alone resizing it) could pull the rug from under them (e.g., SIGBUS on a shrink).
+	//       So, build a fresh one off to the side, and only rename it over the public path once it's ready:
+	//       readers either get the old inode (and its dead kfmon_pid), or a fully initialized new one.
+	const char tmp_path[] = KFMON_STATE_PAGE ".tmp";
+	// NOTE: Stale leftover from a crash?
+	unlink(tmp_path);
+	int fd = open(tmp_path, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+	if (fd == -1) {
+		PFLOG(LOG_WARNING, "open: %m");
+		LOG(LOG_WARNING, "Failed to create the state page at '%s', it won't be published", KFMON_STATE_PAGE);
+		return;
+	}
+	if (ftruncate(fd, (off_t) sizeof(KFMonStatePage)) == -1) {
+		PFLOG(LOG_WARNING, "ftruncate: %m");
+		close(fd);
+		unlink(tmp_path);
+		return;
+	}
+	void* page = mmap(NULL, sizeof(KFMonStatePage), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (page == MAP_FAILED) {
+		PFLOG(LOG_WARNING, "mmap: %m");
+		unlink(tmp_path);
+		return;
+	}
+
+	// Nobody can see it yet, so, no need for the seqlock dance (and a fresh file is already zero-filled).
+	KFMonStatePage* p = page;
+	p->magic          = KFMON_STATE_PAGE_MAGIC;
+	p->version        = KFMON_STATE_PAGE_VERSION;
+	p->size           = (uint16_t) sizeof(*p);
+	p->kfmon_pid      = (int32_t) getpid();
+	// Make sure the first publish_state_page call actually publishes something
+	p->watch_gen      = watchConfigGen - 1U;
+
+	if (rename(tmp_path, KFMON_STATE_PAGE) == -1) {
+		PFLOG(LOG_WARNING, "rename: %m");
+		LOG(LOG_WARNING, "Failed to create the state page at '%s', it won't be published", KFMON_STATE_PAGE);
+		munmap(page, sizeof(KFMonStatePage));
+		unlink(tmp_path);
+		return;
+	}
+	statePage.page = page;
+}
+
+// Refresh the state page, if anything it reflects has changed since the last time (seqlock writer side).
+static void
+    publish_state_page(void)
+{
+	KFMonStatePage* p = statePage.page;
+	if (p == NULL) {
+		return;
+	}
+	uint32_t watch_gen = __atomic_load_n(&watchConfigGen, __ATOMIC_ACQUIRE);
+	if (!statePage.dirty && p->watch_gen == watch_gen) {
+		return;
+	}
+
+	uint32_t seq = p->seq;
+	__atomic_store_n(&p->seq, seq + 1U, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	// The watch table itself only needs to be copied when it has changed
+	if (p->watch_gen != watch_gen) {
+		for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
+			const WatchConfig* watch = &watchConfig[watch_idx];
+			KFMonStateWatch*   slot  = &p->watches[watch_idx];
+			if (!watch->is_active) {
+				*slot = (const KFMonStateWatch){ .pid = -1 };
+				continue;
+			}
+			slot->flags = (uint8_t) (KFMON_STATE_WATCH_ACTIVE |
+						 (watch->hidden ? KFMON_STATE_WATCH_HIDDEN : 0U) |
+						 (watch->block_spawns ? KFMON_STATE_WATCH_BLOCKER : 0U));
+			strtcpy(slot->name, sizeof(slot->name), basename(watch->filename));
+			strtcpy(slot->label, sizeof(slot->label), watch->label);
+		}
+		p->watch_gen = watch_gen;
+	}
+	for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
+		p->watches[watch_idx].pid = (int32_t) get_spawn_pid_for_watch(watch_idx);
+	}
+	p->blocked = is_blocker_running();
+	p->gen++;
+
+	__atomic_store_n(&p->seq, seq + 2U, __ATOMIC_RELEASE);
+	statePage.dirty = false;
+}
+
+// Lock a CountedMutex, keeping track of whether we had to wait for it
+static void
+    counted_mutex_lock(CountedMutex* m)
+{
+	if (pthread_mutex_trylock(&m->mutex) != 0) {
+		pthread_mutex_lock(&m->mutex);
+		m->contended++;
+	}
+	m->acquired++;
+}
+
+static void
+    counted_mutex_unlock(CountedMutex* m)
+{
+	pthread_mutex_unlock(&m->mutex);
+}
+
+// Start our prefetch thread
+static int
+    init_prefetcher(void)
+{
+	// NOTE: Make sure it never catches any of our signals (in particular, SIGCHLD, for the reaper's signalfd).
+	sigset_t all;
+	sigset_t old;
+	sigfillset(&all);
+	pthread_sigmask(SIG_SETMASK, &all, &old);
+
+	pthread_t tid;
+	int       rc = pthread_create(&tid, NULL, prefetch_thread, NULL);
+	pthread_sigmask(SIG_SETMASK, &old, NULL);
+	if (rc != 0) {
+		LOG(LOG_ERR, "Failed to create the prefetch thread: %s", strerror(rc));
+		return -1;
+	}
+	pthread_detach(tid);
+	// NOTE: Purely cosmetic, so don't care if that fails.
+	pthread_setname_np(tid, "kfmon-prefetch");
+
+	return 0;
+}
+
+// Ask the prefetch thread to read ahead the payload of a given watch.
+// Returns false if there's nothing to prefetch.
+static bool
+    queue_prefetch(uint8_t watch_idx)
+{
+	if (watchConfig[watch_idx].prefetch[0] == '\0') {
+		return false;
+	}
+
+	counted_mutex_lock(&prefetcher.lock);
+	// NOTE: If there's already a pending request for this watch, this is essentially a no-op.
+	str5cpy(prefetcher.paths[watch_idx],
+		PREFETCH_SZ_MAX,
+		watchConfig[watch_idx].prefetch,
+		PREFETCH_SZ_MAX,
+		NOTRUNC);
+	prefetcher.pending |= (1U << watch_idx);
+	pthread_cond_signal(&prefetcher.cond);
+	counted_mutex_unlock(&prefetcher.lock);
+
+	DBGLOG("Queued a prefetch request for watch idx %hhu", watch_idx);
+	return true;
+}
+
+// Read ahead a single file, without going over budget. Returns the amount of bytes we asked for.
+static size_t
+    prefetch_file(int dirfd, const char* path, size_t budget)
+{
+	int fd = openat(dirfd, path, O_RDONLY | O_CLOEXEC | O_NOCTTY | O_NONBLOCK);
+	if (fd == -1) {
+		PFMTLOG(LOG_WARNING, "open(%s): %m", path);
+		return 0U;
+	}
+
+	size_t      len = 0U;
+	struct stat st;
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+		len = MIN((size_t) st.st_size, budget);
+		// NOTE: readahead blocks until the I/O is submitted, which is precisely why we're on our own thread.
+		//       Fall back to a WILLNEED hint if the fs doesn't support it.
+		if (len > 0U && readahead(fd, 0, len) == -1) {
+			posix_fadvise(fd, 0, (off_t) len, POSIX_FADV_WILLNEED);
+		}
+	}
+	close(fd);
+
+	return len;
+}
+
+// Read ahead a file, or everything in a directory, without going over budget. Returns the amount of bytes we asked for.
+static size_t
+    prefetch_path(const char* path, size_t budget)
+{
+	struct stat st;
+	if (stat(path, &st) == -1) {
+		PFMTLOG(LOG_WARNING, "stat(%s): %m", path);
+		return 0U;
+	}
+	if (!S_ISDIR(st.st_mode)) {
+		return prefetch_file(AT_FDCWD, path, budget);
+	}
+
+	// Don't chdir (because that mountpoint can go buh-bye), don't follow symlinks, and don't cross fs boundaries.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunknown-pragmas"
+#pragma clang diagnostic ignored "-Wunknown-warning-option"
+#pragma GCC diagnostic ignored "-Wcast-qual"
+	char* const dir[] = { (char*) path, NULL };
+#pragma GCC diagnostic pop
+	FTS* restrict ftsp = fts_open(dir, FTS_PHYSICAL | FTS_NOCHDIR | FTS_XDEV, NULL);
+	if (ftsp == NULL) {
+		PFMTLOG(LOG_WARNING, "fts_open(%s): %m", path);
+		return 0U;
+	}
+
+	size_t           total = 0U;
+	FTSENT* restrict p;
+	while (total < budget && (p = fts_read(ftsp)) != NULL) {
+		if (p->fts_info == FTS_F) {
+			total += prefetch_file(AT_FDCWD, p->fts_accpath, budget - total);
+		}
+	}
+	fts_close(ftsp);
+
+	return total;
+}
+
+// The prefetch thread's main loop
+static void*
+    prefetch_thread(void* arg __attribute__((unused)))
+{
+	// NOTE: So that the main thread can throttle us while quiescent (c.f., enter_quiescent_mode).
+	__atomic_store_n(&prefetcher.tid, (pid_t) syscall(SYS_gettid), __ATOMIC_RELEASE);
+
+	char paths[PREFETCH_SZ_MAX];
+	while (1) {
+		counted_mutex_lock(&prefetcher.lock);
+		while (prefetcher.pending == 0U) {
+			pthread_cond_wait(&prefetcher.cond, &prefetcher.lock.mutex);
+		}
+		uint8_t watch_idx = (uint8_t) __builtin_ctz(prefetcher.pending);
+		prefetcher.pending &= ~(1U << watch_idx);
+		str5cpy(paths, sizeof(paths), prefetcher.paths[watch_idx], PREFETCH_SZ_MAX, NOTRUNC);
+		counted_mutex_unlock(&prefetcher.lock);
+
+		struct timespec t0 = { 0 };
+		clock_gettime(CLOCK_MONOTONIC_RAW, &t0);
+
+		// Walk the list, in order, until we run out of entries or budget
+		size_t total = 0U;
+		char*  saveptr;
+		for (char* tok = strtok_r(paths, ",", &saveptr); tok && total < PREFETCH_MAX_BYTES;
+		     tok       = strtok_r(NULL, ",", &saveptr)) {
+			// Trim
+			tok += strspn(tok, " \t");
+			size_t tok_len = strlen(tok);
+			while (tok_len > 0U && (tok[tok_len - 1U] == ' ' || tok[tok_len - 1U] == '\t')) {
+				tok[--tok_len] = '\0';
+			}
+			if (tok[0] != '/') {
+				MTLOG(LOG_WARNING, "Skipping non-absolute prefetch entry '%s' for watch idx %hhu", tok, watch_idx);
+				continue;
+			}
+
+			total += prefetch_path(tok, PREFETCH_MAX_BYTES - total);
+		}
+
+		struct timespec t1 = { 0 };
+		clock_gettime(CLOCK_MONOTONIC_RAW, &t1);
+		MTLOG(LOG_INFO,
+		      "Prefetched %zu KB for watch idx %hhu in %ldms%s",
+		      total / 1024U,
+		      watch_idx,
+		      (long) ((t1.tv_sec - t0.tv_sec) * 1000L + (t1.tv_nsec - t0.tv_nsec) / 1000000L),
+		      total >= PREFETCH_MAX_BYTES ? " (budget exhausted)" : "");
+	}
+
+	return NULL;
+}
+
+// Report a failed step to our parent, from a spawn child (c.f., spawn_process).
+static void
+    report_spawn_step(int status_fd, SpawnStep step, int err)
+{
+	const struct spawn_status status = { .step = step, .err = err };
+	// NOTE: The pipe can't be full, and there isn't much we could do about it anyway.
+	if (write(status_fd, &status, sizeof(status)) != (ssize_t) sizeof(status)) {
+		return;
+	}
+}
+
+// What runs in our spawn children, until they exec.
+// NOTE: We share our parent's address space (and it's suspended until we exec or die),
+//       so, much like after a vfork(), we can only use async-safe functions, and we must not touch anything it owns!
+//       We don't share its signal handlers, though (no CLONE_SIGHAND), so restoring those is fine.
+static int
+    spawn_child(void* arg)
+{
+	const struct spawn_args* args = arg;
+
+	// Do the whole stdin/stdout/stderr dance again,
+	// to ensure that child process doesn't inherit our tweaked fds...
+	dup2(origStdin, fileno(stdin));
+	dup2(origStdout, fileno(stdout));
+	dup2(origStderr, fileno(stderr));
+	close(origStdin);
+	close(origStdout);
+	close(origStderr);
+	// Restore signals
+	struct sigaction sa = { .sa_handler = SIG_DFL, .sa_flags = SA_RESTART };
+	sigaction(SIGHUP, &sa, NULL);
+	// NOTE: Our parent blocked everything around the clone, so that nothing can run one of its handlers
+	//       on its own stack & data from here. Reset every caught signal (our libraries may have set some up) before
+	//       we unblock anything, exactly like posix_spawn() does (ignored ones stay ignored, as they would through exec).
+	for (int sig = 1; sig < NSIG; sig++) {
+		struct sigaction old;
+		if (sigaction(sig, NULL, &old) == 0 && old.sa_handler != SIG_DFL && old.sa_handler != SIG_IGN) {
+			sigaction(sig, &sa, NULL);
+		}
+	}
+	// We may have blocked SIGCHLD for our signalfd, don't pass that on.
+	sigset_t mask;
+	sigemptyset(&mask);
+	sigprocmask(SIG_SETMASK, &mask, NULL);
+	// Apply the watch's scheduling & resource controls.
+	// NOTE: These are all plain syscalls, and they all only affect the calling process (i.e., us, not our parent).
+	//       Failures are reported, but aren't fatal: running with our own settings beats not running at all.
+	const SpawnTuning* tuning = args->tuning;
+	// Join the cgroup first, so that its limits & accounting cover everything else.
+	if (args->cgroup_procs[0] != '\0') {
+		int fd = open(args->cgroup_procs, O_WRONLY | O_CLOEXEC);
+		if (fd == -1) {
+			report_spawn_step(args->status_fd, SPAWN_STEP_CGROUP, errno);
+		} else {
+			// NOTE: Writing 0 moves the writer itself
+			if (write(fd, "0", 1U) == -1) {
+				report_spawn_step(args->status_fd, SPAWN_STEP_CGROUP, errno);
+			}
+			close(fd);
+		}
+	}
+	for (uint8_t i = 0U; i < tuning->rlimits_count; i++) {
+		if (setrlimit(tuning->rlimits[i].resource, &tuning->rlimits[i].rlim) == -1) {
+			report_spawn_step(args->status_fd, SPAWN_STEP_RLIMIT, errno);
+		}
+	}
+	if (tuning->cpu_mask != 0U) {
+		cpu_set_t cpus;
+		CPU_ZERO(&cpus);
+		for (unsigned int cpu = 0U; cpu < 32U; cpu++) {
+			if (tuning->cpu_mask & (1U << cpu)) {
+				CPU_SET(cpu, &cpus);
+			}
+		}
+		if (sched_setaffinity(0, sizeof(cpus), &cpus) == -1) {
+			report_spawn_step(args->status_fd, SPAWN_STEP_AFFINITY, errno);
+		}
+	}
+	if (tuning->set_sched) {
+		const struct sched_param param = { .sched_priority = tuning->sched_priority };
+		if (sched_setscheduler(0, tuning->sched_policy, &param) == -1) {
+			report_spawn_step(args->status_fd, SPAWN_STEP_SCHED, errno);
+		}
+	}
+	if (tuning->ioprio != 0) {
+		if (syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, tuning->ioprio) == -1) {
+			report_spawn_step(args->status_fd, SPAWN_STEP_IOPRIO, errno);
+		}
+	}
+	if (tuning->set_nice) {
+		if (setpriority(PRIO_PROCESS, 0, tuning->nice) == -1) {
+			report_spawn_step(args->status_fd, SPAWN_STEP_NICE, errno);
+		}
+	}
+	// Move a standby's gate where it expects it, and let it survive the exec
+	// (our fd table is our own, so this doesn't affect our parent's copy).
+	if (args->gate_fd != -1) {
+		if (args->gate_fd == KFMON_STANDBY_FDNO) {
+			fcntl(args->gate_fd, F_SETFD, 0);
+		} else {
+			dup2(args->gate_fd, KFMON_STANDBY_FDNO);
+		}
+	}
+	// NOTE: We used to use execvpe when being launched from udev,
+	//       in order to sanitize all the crap we inherited from udev's env ;).
+	//       Now, we actually rely on the specific env we inherit from rcS/on-animator!
+#ifdef SYS_execveat
+	if (args->exec_fd != -1) {
+		syscall(SYS_execveat, args->exec_fd, "", args->command, args->envp, AT_EMPTY_PATH);
+		// NOTE: If that failed (e.g., ENOSYS on Linux < 3.19), just try again by path.
+	}
+#endif
+	if (args->exec_path[0] != '\0') {
+		execve(args->exec_path, args->command, args->envp);
+		// NOTE: Much like execvp, run a script without a shebang through the shell (c.f., resolve_action).
+		if (errno == ENOEXEC) {
+			size_t argc = 0U;
+			while (args->command[argc]) {
+				argc++;
+			}
+			// NOTE: We're on our own stack, so this is fine.
+			const char** argv = alloca((argc + 2U) * sizeof(*argv));
+			argv[0]           = "/bin/sh";
+			argv[1]           = args->exec_path;
+			for (size_t i = 1U; i <= argc; i++) {
+				argv[i + 1U] = args->command[i];
+			}
+			execve("/bin/sh", (char* const*) (uintptr_t) argv, args->envp);
+		}
+	} else {
+		execvpe(*args->command, args->command, args->envp);
+	}
+
+	// NOTE: This will only ever be reached on error, so report errno to our parent via the status pipe.
+	//       (On success, the pipe is closed by the exec, thanks to O_CLOEXEC).
+	//       If even that fails, our parent will assume the exec went through, and we'll get reaped as usual.
+	report_spawn_step(args->status_fd, SPAWN_STEP_EXEC, errno);
+	_exit(127);
+}
+
+// Launch a process, and return its pid...
+// Initially inspired from popen2() implementations from https://stackoverflow.com/questions/548063
+// As well as the glibc's system() call.
+// NOTE: We used to fork() + execvp() by hand, but duplicating the page tables of a process that has SQLite & FBInk
+//       mapped is a measurable chunk of the launch latency on our low-end SoCs (c.f., utils/spawn-bench.c).
+//       We now do what posix_spawn() does on modern glibcs instead: a CLONE_VM | CLONE_VFORK child on its own stack,
+//       which allows us to use the usual CLOEXEC pipe trick to learn whether the exec actually succeeded
+//       (something posix_spawn() can't tell us on glibc < 2.24).
+// exec_path & exec_fd are the pre-resolved action (c.f., actionCache), tuning its watch's scheduling & resource controls.
+// If gate_fd isn't -1, it's passed on to the child, and advertised in its env (c.f., arm_standby).
+// NOTE: This runs in our spawn helper instead when there's one (c.f., spawn_helper_main), so, no FBInk in here!
+// Returns -1 on failure, with errno set to the reason the child couldn't be launched (a failed child is already reaped).
+static pid_t
+    launch_process(char* const* command, const char* exec_path, int exec_fd, int gate_fd, const SpawnTuning* tuning)
+{
+	// NOTE: Since our parent is suspended until the child execs or dies, a single stack is enough.
+	if (spawn_stack == NULL) {
+		void* stack = mmap(NULL,
+				   SPAWN_STACK_SIZE,
+				   PROT_READ | PROT_WRITE,
+				   MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK,
+				   -1,
+				   0);
+		if (stack == MAP_FAILED) {
+			int err = errno;
+			PFLOG(LOG_ERR, "mmap: %m");
+			errno = err;
+			return -1;
+		}
+		spawn_stack = stack;
+	}
+
+	int pfd[2];
+	if (pipe2(pfd, O_CLOEXEC) == -1) {
+		int err = errno;
+		PFLOG(LOG_ERR, "pipe2: %m");
+		errno = err;
+		return -1;
+	}
+
+	// NOTE: We can't touch our env from the child, since it's shared with us, so, build a new one for a standby.
+	char** envp = environ;
+	if (gate_fd != -1) {
+		size_t n = 0U;
+		while (environ[n]) {
+			n++;
+		}
+		envp = calloc(n + 2U, sizeof(*envp));
+		if (envp == NULL) {
+			int err = errno;
+			PFLOG(LOG_ERR, "calloc: %m");
+			close(pfd[0]);
+			close(pfd[1]);
+			errno = err;
+			return -1;
+		}
+		memcpy(envp, environ, n * sizeof(*envp));
+		envp[n] = (char*) (uintptr_t) KFMON_STANDBY_ENV;
+	}
+
+	// NOTE: Build this here, as the child can't afford to.
+	char cgroup_procs[CFG_SZ_MAX + sizeof("/cgroup.procs")] = { 0 };
+	if (tuning->cgroup[0] != '\0') {
+		snprintf(cgroup_procs, sizeof(cgroup_procs), "%s/cgroup.procs", tuning->cgroup);
+	}
+
+	struct spawn_args args = { .command      = command,
+				   .exec_path    = exec_path,
+				   .exec_fd      = exec_fd,
+				   .envp         = envp,
+				   .gate_fd      = gate_fd,
+				   .tuning       = tuning,
+				   .cgroup_procs = cgroup_procs,
+				   .status_fd    = pfd[1] };
+	// Block every signal until the child is gone, since it runs on our memory until then (c.f., spawn_child).
+	sigset_t all_signals;
+	sigset_t old_mask;
+	sigfillset(&all_signals);
+	pthread_sigmask(SIG_BLOCK, &all_signals, &old_mask);
+	// NOTE: The stack grows down on everything we run on.
+	pid_t pid = clone(spawn_child,
+			  (uint8_t*) spawn_stack + SPAWN_STACK_SIZE,
+			  CLONE_VM | CLONE_VFORK | SIGCHLD,
+			  &args);
+	int   err = errno;
+	pthread_sigmask(SIG_SETMASK, &old_mask, NULL);
+	close(pfd[1]);
+	if (envp != environ) {
+		free(envp);
+	}
+
+	if (pid == -1) {
+		close(pfd[0]);
+		LOG(LOG_ERR, "Failed to spawn %s: clone: %s", *command, strerror(err));
+		errno = err;
+		return -1;
+	}
+
+	// We're only resumed once the child has exec'ed or died, so this won't block:
+	// we get whatever failures it reported, followed by EOF (the exec's failure being the final one, if any).
+	int                 exec_err = 0;
+	struct spawn_status status;
+	ssize_t             rc;
+	while ((rc = read(pfd[0], &status, sizeof(status))) != 0) {
+		if (rc == -1) {
+			if (errno == EINTR) {
+				continue;
+			}
+			break;
+		}
+		if (rc != (ssize_t) sizeof(status)) {
+			break;
+		}
+
+		if (status.step == SPAWN_STEP_EXEC) {
+			exec_err = status.err;
+		} else {
+			LOG(LOG_WARNING,
+			    "Failed to apply the %s setting to %s: %s",
+			    spawn_step_names[status.step],
+			    *command,
+			    strerror(status.err));
+		}
+	}
+	close(pfd[0]);
+
+	if (exec_err != 0) {
+		// The child is already dead, so, reap it right now, it's none of the main loop's business.
+		waitpid(pid, NULL, 0);
+		LOG(LOG_ERR, "Failed to spawn %s: exec: %s", *command, strerror(exec_err));
+		errno = exec_err;
+		return -1;
+	}
+
+	return pid;
+}
+
+// Spawn the action of a given watch, and return its pid...
+// With a bit of added tracking to handle reaping from the main loop.
+// If gate_fd isn't -1, it's passed on to the child, and advertised in its env (c.f., arm_standby).
+// On success, exec_us is set to the time it took to get to the exec.
+// Returns -1 on failure, with errno set to the reason the child couldn't be launched.
+static pid_t
+    spawn_process(char* const* command, uint8_t watch_idx, int gate_fd, long int* exec_us)
+{
+	struct timespec t0 = { 0 };
+	clock_gettime(CLOCK_MONOTONIC_RAW, &t0);
+
+#ifdef KFMON_SPAWN_HELPER
+	pid_t pid = request_spawn(command, watch_idx, gate_fd);
+#else
+	pid_t pid = launch_process(
+	    command, actionCache[watch_idx].path, actionCache[watch_idx].fd, gate_fd, &watchConfig[watch_idx].tuning);
+#endif
+	if (pid == -1) {
+		// NOTE: The details have already been logged.
+		int err = errno;
+		FB_PRINTF("[KFMon] Failed to launch %s: %s!", basename(watchConfig[watch_idx].action), strerror(err));
+		errno = err;
+		return -1;
+	}
+
+	struct timespec t1 = { 0 };
+	clock_gettime(CLOCK_MONOTONIC_RAW, &t1);
+	*exec_us = (long int) ((t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_nsec - t0.tv_nsec) / 1000L);
+	DBGLOG("Spawn to exec took %ldus", *exec_us);
+
+	return pid;
+}
+
+#ifdef KFMON_SPAWN_HELPER
+// Fork our spawn helper (c.f., spawn_helper_main), while we're still small (i.e., before SQLite & FBInk are setup).
+// NOTE: Every fork it'll ever do then only has to copy *its* page tables, and our own memory never reaches the children.
+static void
+    start_spawn_helper(void)
+{
+	int req_sv[2];
+	int exit_sv[2];
+	if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, req_sv) == -1) {
+		PFLOG(LOG_ERR, "Aborting: socketpair: %m");
+		exit(EXIT_FAILURE);
+	}
+	if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, exit_sv) == -1) {
+		PFLOG(LOG_ERR, "Aborting: socketpair: %m");
+		exit(EXIT_FAILURE);
+	}
+
+	pid_t pid = fork();
+	if (pid == -1) {
+		PFLOG(LOG_ERR, "Aborting: fork: %m");
+		exit(EXIT_FAILURE);
+	} else if (pid == 0) {
+		close(req_sv[0]);
+		close(exit_sv[0]);
+		// Make it easy to tell apart from us
+		prctl(PR_SET_NAME, (unsigned long) "kfmon-spawner", 0UL, 0UL, 0UL);
+		spawn_helper_main(req_sv[1], exit_sv[1]);
+	}
+
+	close(req_sv[1]);
+	close(exit_sv[1]);
+	spawnHelper.pid     = pid;
+	spawnHelper.req_fd  = req_sv[0];
+	spawnHelper.exit_fd = exit_sv[0];
+	LOG(LOG_INFO, "Started spawn helper process %ld", (long) pid);
+}
+
+// Our spawn helper's main loop: launch whatever we're asked to (c.f., request_spawn),
+// and report our children's demise once we've reaped them (c.f., on_spawn_helper_event).
+// Exits as soon as the daemon is gone (i.e., on EOF).
+static void
+    spawn_helper_main(int req_fd, int exit_fd)
+{
+	// We're not multi-threaded, so, reap our children via a signalfd (c.f., init_reaper).
+	sigset_t mask;
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGCHLD);
+	if (sigprocmask(SIG_BLOCK, &mask, NULL) == -1) {
+		PFLOG(LOG_ERR, "Aborting: sigprocmask: %m");
+		_exit(EXIT_FAILURE);
+	}
+	int sfd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+	if (sfd == -1) {
+		PFLOG(LOG_ERR, "Aborting: signalfd: %m");
+		_exit(EXIT_FAILURE);
+	}
+
+	struct pollfd pfds[2] = { { .fd = req_fd, .events = POLLIN }, { .fd = sfd, .events = POLLIN } };
+	while (1) {
+		if (poll(pfds, 2, -1) == -1) {
+			if (errno == EINTR) {
+				continue;
+			}
+			PFLOG(LOG_ERR, "Aborting: poll: %m");
+			_exit(EXIT_FAILURE);
+		}
+
+		if (pfds[1].revents & POLLIN) {
+			// Drain the signalfd, and reap everything that's ready (c.f., on_sigchld_event).
+			struct signalfd_siginfo fdsi;
+			while (read(sfd, &fdsi, sizeof(fdsi)) == sizeof(fdsi)) {
+				;
+			}
+
+			struct spawn_exit ex;
+			while ((ex.pid = wait4(-1, &ex.wstatus, WNOHANG, &ex.ru)) > 0) {
+				if (send(exit_fd, &ex, sizeof(ex), MSG_NOSIGNAL) == -1) {
+					// The daemon is gone, so are we.
+					_exit(EXIT_SUCCESS);
+				}
+			}
+		}
+
+		if (pfds[0].revents) {
+			struct spawn_request req;
+			struct iovec         iov = { .iov_base = &req, .iov_len = sizeof(req) };
+			union
+			{
+				char           buf[CMSG_SPACE(2U * sizeof(int))];
+				struct cmsghdr align;
+			} cmsgbuf;
+			struct msghdr msg = { .msg_iov        = &iov,
+					      .msg_iovlen     = 1,
+					      .msg_control    = cmsgbuf.buf,
+					      .msg_controllen = sizeof(cmsgbuf) };
+			ssize_t       len = recvmsg(req_fd, &msg, MSG_CMSG_CLOEXEC);
+			if (len == -1 && errno == EINTR) {
+				continue;
+			}
+			if (len <= 0) {
+				// The daemon is gone, so are we.
+				_exit(EXIT_SUCCESS);
+			}
+
+			int    fds[2] = { -1, -1 };
+			size_t nfds   = 0U;
+			for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+				if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+					nfds = (cmsg->cmsg_len - CMSG_LEN(0U)) / sizeof(int);
+					memcpy(fds, CMSG_DATA(cmsg), nfds * sizeof(int));
+				}
+			}
+
+			struct spawn_reply reply = { .pid = -1, .err = EPROTO };
+			if ((size_t) len == sizeof(req) && !(msg.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) &&
+			    nfds == (size_t) req.with_exec_fd + (size_t) req.with_gate_fd) {
+				int         exec_fd = req.with_exec_fd ? fds[0] : -1;
+				int         gate_fd = req.with_gate_fd ? fds[nfds - 1U] : -1;
+				char* const cmd[]   = { req.argv0, NULL };
+				reply.pid           = launch_process(cmd, req.exec_path, exec_fd, gate_fd, &req.tuning);
+				reply.err           = (reply.pid == -1) ? errno : 0;
+			} else {
+				LOG(LOG_ERR, "Received a malformed spawn request");
+			}
+			for (size_t i = 0U; i < nfds; i++) {
+				close(fds[i]);
+			}
+
+			if (send(req_fd, &reply, sizeof(reply), MSG_NOSIGNAL) == -1) {
+				_exit(EXIT_SUCCESS);
+			}
+		}
+	}
+}
+
+// Ask our spawn helper to launch the action of a given watch (c.f., spawn_process).
+// Returns its pid, or -1 on failure, with errno set to the reason the child couldn't be launched.
+static pid_t
+    request_spawn(char* const* command, uint8_t watch_idx, int gate_fd)
+{
+	struct spawn_request req = { .tuning = watchConfig[watch_idx].tuning };
+	str5cpy(req.argv0, sizeof(req.argv0), *command, CFG_SZ_MAX, TRUNC);
+	str5cpy(req.exec_path, sizeof(req.exec_path), actionCache[watch_idx].path, PATH_MAX, NOTRUNC);
+	int    fds[2];
+	size_t nfds = 0U;
+	if (actionCache[watch_idx].fd != -1) {
+		fds[nfds++]      = actionCache[watch_idx].fd;
+		req.with_exec_fd = true;
+	}
+	if (gate_fd != -1) {
+		fds[nfds++]      = gate_fd;
+		req.with_gate_fd = true;
+	}
+
+	struct iovec  iov = { .iov_base = &req, .iov_len = sizeof(req) };
+	struct msghdr msg = { .msg_iov = &iov, .msg_iovlen = 1 };
+	union
+	{
+		char           buf[CMSG_SPACE(2U * sizeof(int))];
+		struct cmsghdr align;
+	} cmsgbuf = { 0 };
+	if (nfds > 0U) {
+		msg.msg_control      = cmsgbuf.buf;
+		msg.msg_controllen   = CMSG_SPACE(nfds * sizeof(int));
+		struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+		cmsg->cmsg_level     = SOL_SOCKET;
+		cmsg->cmsg_type      = SCM_RIGHTS;
+		cmsg->cmsg_len       = CMSG_LEN(nfds * sizeof(int));
+		memcpy(CMSG_DATA(cmsg), fds, nfds * sizeof(int));
+	}
+
+	// NOTE: The helper replies as soon as the child has exec'ed (or failed to), so we can afford to block here.
+	struct spawn_reply reply;
+	ssize_t            rc;
+	if (sendmsg(spawnHelper.req_fd, &msg, MSG_NOSIGNAL) == -1) {
+		rc = -1;
+	} else {
+		do {
+			rc = recv(spawnHelper.req_fd, &reply, sizeof(reply), 0);
+		} while (rc == -1 && errno == EINTR);
+	}
+	if (rc != (ssize_t) sizeof(reply)) {
+		LOG(LOG_ERR, "Lost our spawn helper (pid %ld), aborting!", (long) spawnHelper.pid);
+		FB_PRINT("[KFMon] Lost the spawn helper!");
+		exit(EXIT_FAILURE);
+	}
+
+	if (reply.pid == -1) {
+		errno = reply.err;
+	}
+	return reply.pid;
+}
+
+// Reactor callback for our spawn helper's exit notifications (c.f., spawn_helper_main).
+static void
+    on_spawn_helper_event(ReactorSource* src, uint32_t events __attribute__((unused)))
+{
+	struct spawn_exit ex;
+	ssize_t           rc;
+	while ((rc = recv(src->fd, &ex, sizeof(ex), MSG_DONTWAIT)) == (ssize_t) sizeof(ex)) {
+		int8_t i = get_pt_entry_for_pid(ex.pid);
+		if (i < 0) {
+			LOG(LOG_WARNING, "Reaped unknown process %ld", (long) ex.pid);
+			continue;
+		}
+		reap_process((uint8_t) i, ex.wstatus, &ex.ru);
+	}
+	if (rc == -1 && (errno == EAGAIN || errno == EINTR)) {
+		return;
+	}
+
+	// Anything else means the helper is gone, and we can't launch anything without it.
+	LOG(LOG_ERR, "Lost our spawn helper (pid %ld), aborting!", (long) spawnHelper.pid);
+	FB_PRINT("[KFMon] Lost the spawn helper!");
+	exit(EXIT_FAILURE);
+}
+#endif
+
+// Launch the action of a given watch (or release its standby), and keep track of it.
+// Returns its pid, or -1 on failure, with errno set to the reason the child couldn't be launched.
+static pid_t
+    spawn(char* const* command, uint8_t watch_idx)
+{
+	// If we've got a standby waiting for us, just let it go
+	int8_t sb = get_standby_for_watch(watch_idx);
+	if (sb >= 0) {
+		struct timespec t0 = { 0 };
+		clock_gettime(CLOCK_MONOTONIC_RAW, &t0);
+		if (send(PT.spawn_gates[sb], "go\n", 3U, MSG_NOSIGNAL) == 3) {
+			close(PT.spawn_gates[sb]);
+			PT.spawn_gates[sb] = -1;
+			// NOTE: What the standby took to get to its exec when it was armed is none of the user's business,
+			//       what they're waiting on is the release, so that's what we account for.
+			struct timespec t1 = { 0 };
+			clock_gettime(CLOCK_MONOTONIC_RAW, &t1);
+			PT.spawn_exec_us[sb] =
+			    (long int) ((t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_nsec - t0.tv_nsec) / 1000L);
+			set_process_state((uint8_t) sb, SPAWN_RUNNING);
+
+			LOG(LOG_NOTICE,
+			    "Released standby process %ld (%s -> %s @ watch idx %hhu) . . .",
+			    (long) PT.spawn_pids[sb],
+			    watchConfig[watch_idx].filename,
+			    watchConfig[watch_idx].action,
+			    watch_idx);
+			if (daemonConfig.with_notifications) {
+				FB_PRINTF("[KFMon] Launched %s :)", basename(watchConfig[watch_idx].action));
+			}
+			if (watchConfig[watch_idx].block_spawns) {
+				enter_quiescent_mode();
+			}
+			return PT.spawn_pids[sb];
+		}
+		// It's probably dying on us, let it, and launch a fresh one.
+		PFLOG(LOG_WARNING, "send: %m");
+		disarm_standby((uint8_t) sb);
+	}
+
+	long int exec_us = 0L;
+	pid_t    pid     = spawn_process(command, watch_idx, -1, &exec_us);
+	if (pid == -1) {
+		// NOTE: spawn_process already complained about it, keep track of it for status & subscribers.
+		int err = errno;
+		spawnStats[watch_idx].spawn_failures++;
+		spawnStats[watch_idx].last_spawn_errno = err;
+		NOTIFY_SUBSCRIBERS("failed:%hhu:%d", watch_idx, err);
+		errno = err;
+		return -1;
+	}
+
+	// Keep track of the process
+	int8_t i = get_next_available_pt_entry();
+	if (i < 0) {
+		// NOTE: If we ever hit this error codepath,
+		//       we don't have to worry about leaving that last spawn as a zombie:
+		//       One of the benefits of the double-fork we do to daemonize is that, on our death,
+		//       our children will get reparented to init, which, by design,
+		//       will handle the reaping automatically.
+		LOG(LOG_ERR,
+		    "Failed to find an available entry in our process table for pid %ld, aborting!",
+		    (long) pid);
+		FB_PRINT("[KFMon] Can't spawn any more processes!");
+		exit(EXIT_FAILURE);
+	} else {
+		add_process_to_table((uint8_t) i, pid, watch_idx, SPAWN_RUNNING);
+		PT.spawn_exec_us[i] = exec_us;
+		// NOTE: The actual reaping happens in the main loop, either via this process's pidfd,
+		//       or via SIGCHLD.
+		track_process((uint8_t) i);
+
+		DBGLOG("Assigned pid %ld (from watch idx %hhu) to process table entry idx %hhd",
+		       (long) pid,
+		       watch_idx,
+		       i);
+		LOG(LOG_NOTICE,
+		    "Spawned process %ld (%s -> %s @ watch idx %hhu) . . .",
+		    (long) pid,
+		    watchConfig[watch_idx].filename,
+		    watchConfig[watch_idx].action,
+		    watch_idx);
+		if (daemonConfig.with_notifications) {
+			FB_PRINTF("[KFMon] Launched %s :)", basename(watchConfig[watch_idx].action));
+		}
+		if (watchConfig[watch_idx].block_spawns) {
+			enter_quiescent_mode();
+		}
+	}
+
+	return pid;
+}
+
+// Returns the process table index of the armed standby of a given watch, or -1 if there isn't one.
+static int8_t
+    get_standby_for_watch(uint8_t watch_idx)
+{
+	return PT.standby[watch_idx];
+}
+
+// Launch the action of a given watch ahead of time, and leave it waiting on its gate.
+static void
+    arm_standby(uint8_t watch_idx)
+{
+	// NOTE: Anything running off of the target mountpoint would prevent Nickel from unmounting it for an USBMS session,
+	//       so, we can't leave a standby hanging around in there. Point the watch to a wrapper on the rootfs instead.
+	const char* path = actionCache[watch_idx].path;
+	if (path[0] == '\0' ||
+	    strncmp(path, KFMON_TARGET_MOUNTPOINT "/", sizeof(KFMON_TARGET_MOUNTPOINT)) == 0) {
+		LOG(LOG_WARNING,
+		    "Cannot arm a standby for watch idx %hhu, as its action (%s) either failed validation or lives in %s",
+		    watch_idx,
+		    watchConfig[watch_idx].action,
+		    KFMON_TARGET_MOUNTPOINT);
+		return;
+	}
+
+	// Make sure we've got room for it *before* launching anything
+	int8_t i = get_next_available_pt_entry();
+	if (i < 0) {
+		LOG(LOG_WARNING, "No process table entry left to arm a standby for watch idx %hhu", watch_idx);
+		return;
+	}
+
+	// NOTE: A socketpair instead of a pipe, so we can use MSG_NOSIGNAL instead of having to deal with SIGPIPE.
+	int sv[2];
+	if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) == -1) {
+		PFLOG(LOG_WARNING, "socketpair: %m");
+		return;
+	}
+
+	char* const cmd[]   = { watchConfig[watch_idx].action, NULL };
+	long int    exec_us = 0L;
+	pid_t       pid     = spawn_process(cmd, watch_idx, sv[1], &exec_us);
+	close(sv[1]);
+	if (pid == -1) {
+		close(sv[0]);
+		return;
+	}
+
+	add_process_to_table((uint8_t) i, pid, watch_idx, SPAWN_STANDBY);
+	PT.spawn_gates[i]   = sv[0];
+	PT.spawn_exec_us[i] = exec_us;
+	track_process((uint8_t) i);
+
+	LOG(LOG_NOTICE,
+	    "Armed standby process %ld (%s -> %s @ watch idx %hhu)",
+	    (long) pid,
+	    watchConfig[watch_idx].filename,
+	    watchConfig[watch_idx].action,
+	    watch_idx);
+}
+
+// Arm a standby for every standby watch that doesn't have one (and isn't currently running)
+static void
+    arm_standbys(void)
+{
+	for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
+		if (!watchConfig[watch_idx].is_active || !watchConfig[watch_idx].standby) {
+			continue;
+		}
+
+		if (is_watch_already_spawned(watch_idx) || get_standby_for_watch(watch_idx) >= 0) {
+			continue;
+		}
+
+		arm_standby(watch_idx);
+	}
+}
+
+// Close the gate of a standby, which should make it exit (it'll then be reaped as usual).
+static void
+    disarm_standby(uint8_t i)
+{
+	LOG(LOG_INFO,
+	    "Disarming standby process %ld (from watch idx %hhd)",
+	    (long) PT.spawn_pids[i],
+	    PT.spawn_watchids[i]);
+
+	close(PT.spawn_gates[i]);
+	PT.spawn_gates[i] = -1;
+	set_process_state(i, SPAWN_DISARMED);
+}
+
+// Disarm all our standbys
+static void
+    disarm_standbys(void)
+{
+	for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
+		if (PT.standby[watch_idx] >= 0) {
+			disarm_standby((uint8_t) PT.standby[watch_idx]);
+		}
+	}
+}
+
+// Check if a given inotify watch already has a spawn running
+static bool
+    is_watch_already_spawned(uint8_t watch_idx)
+{
+	// NOTE: Standbys (armed or on their way out) don't count.
+	return PT.running[watch_idx] != -1;
+}
+
+// Check if a watch flagged as a spawn blocker (e.g., KOReader or Plato) is already running
+// NOTE: This is mainly to prevent spurious spawns that might be unwittingly caused by their file manager
+//       (be it through metadata reading, thumbnails creation, or whatever).
+//       Another workaround is of course to kill KFMon as part of their startup process...
+static bool
+    is_blocker_running(void)
+{
+	return PT.running_blockers > 0U;
+}
+
+// Check if spawns are inhibited by the global block file
+static bool
+    are_spawns_blocked(void)
+{
+	const char block_path[] = KFMON_CONFIGPATH "/BLOCK";
+	if (access(block_path, F_OK) == 0) {
+		// Global block file is here, prevent new spawns...
+		return true;
+	}
+
+	return false;
+}
+
+// While a spawn blocker is running, keep our head down:
+// stop reacting to the blocker's own activity on our target files, drop the prefetch thread to the idle CPU & I/O classes,
+// and give back the memory we don't need.
+// NOTE: The main thread keeps its scheduling policy: it still has to service IPC clients in the meantime.
+static void
+    enter_quiescent_mode(void)
+{
+	if (quiescence.active) {
+		return;
+	}
+
+	LOG(LOG_NOTICE, "A spawn blocker is running, going quiescent");
+
+	// NOTE: The prefetch thread is the only one doing bulk I/O, so that's the one we throttle.
+	pid_t tid = __atomic_load_n(&prefetcher.tid, __ATOMIC_ACQUIRE);
+	if (tid > 0) {
+		quiescence.sched_policy = sched_getscheduler(tid);
+		if (quiescence.sched_policy == -1 || sched_getparam(tid, &quiescence.sched_param) == -1) {
+			PFLOG(LOG_WARNING, "sched_getscheduler: %m");
+			quiescence.sched_policy = SCHED_OTHER;
+			quiescence.sched_param  = (const struct sched_param){ 0 };
+		}
+		const struct sched_param idle_param = { 0 };
+		if (sched_setscheduler(tid, SCHED_IDLE, &idle_param) == -1) {
+			PFLOG(LOG_WARNING, "sched_setscheduler: %m");
+		}
+		long int ioprio = syscall(SYS_ioprio_get, IOPRIO_WHO_PROCESS, tid);
+		quiescence.ioprio = ioprio == -1 ? 0 : (int) ioprio;
+		if (syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, tid, IOPRIO_PRIO_VALUE(IOPRIO_CLASS_IDLE, 0)) == -1) {
+			PFLOG(LOG_WARNING, "ioprio_set: %m");
+		}
+	}
+
+	// Our spawn stack is lazily re-created on the next spawn.
+	// NOTE: We don't keep a DB connection around, so SQLite's page cache is already gone.
+	if (spawn_stack) {
+		munmap(spawn_stack, SPAWN_STACK_SIZE);
+		spawn_stack = NULL;
+	}
+	malloc_trim(0);
+
+	quiescence.active = true;
+}
+
+// Get back to work once the spawn blocker is gone
+static void
+    leave_quiescent_mode(void)
+{
+	if (!quiescence.active) {
+		return;
+	}
+
+	LOG(LOG_NOTICE, "No more spawn blockers running, leaving quiescent mode");
+
+	pid_t tid = __atomic_load_n(&prefetcher.tid, __ATOMIC_ACQUIRE);
+	if (tid > 0) {
+		if (sched_setscheduler(tid, quiescence.sched_policy, &quiescence.sched_param) == -1) {
+			PFLOG(LOG_WARNING, "sched_setscheduler: %m");
+		}
+		if (syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, tid, quiescence.ioprio) == -1) {
+			PFLOG(LOG_WARNING, "ioprio_set: %m");
+		}
+	}
+
+	// NOTE: An open/close pair that happened in the meantime is simply lost, which is what we'd have done with it anyway.
+	quiescence.active = false;
+}
+
+// Enter or leave quiescent mode, depending on whether a spawn blocker is currently running
+static void
+    update_quiescent_mode(void)
+{
+	if (is_blocker_running()) {
+		enter_quiescent_mode();
+	} else {
+		leave_quiescent_mode();
+	}
+}
+
+// Return the pid of the spawn of a given inotify watch
+static pid_t
+    get_spawn_pid_for_watch(uint8_t watch_idx)
+{
+	int8_t i = PT.running[watch_idx];
+	return i >= 0 ? PT.spawn_pids[i] : -1;
+}
+
+// Setup our epoll instance
+static int
+    reactor_init(void)
+{
+	reactor.epfd = epoll_create1(EPOLL_CLOEXEC);
+	if (reactor.epfd == -1) {
+		PFLOG(LOG_ERR, "epoll_create1: %m");
+		return -1;
+	}
+
+	return 0;
+}
+
+// Register fd with the reactor, cb will be called with the epoll events that fired for it.
+// Returns the new source on success, NULL on failure.
+static ReactorSource*
+    reactor_add(int fd, uint32_t events, reactor_cb cb, void* data)
+{
+	ReactorSource* src = calloc(1U, sizeof(*src));
+	if (src == NULL) {
+		PFLOG(LOG_ERR, "calloc: %m");
+		return NULL;
+	}
+	src->fd   = fd;
+	src->cb   = cb;
+	src->data = data;
+
+	struct epoll_event ev = { .events = events, .data.ptr = src };
+	if (epoll_ctl(reactor.epfd, EPOLL_CTL_ADD, fd, &ev) == -1) {
+		PFLOG(LOG_ERR, "epoll_ctl: %m");
+		free(src);
+		return NULL;
+	}
+
+	return src;
+}
+
+// Change the set of epoll events we're interested in for a registered source.
+static void
+    reactor_mod(ReactorSource* src, uint32_t events)
+{
+	struct epoll_event ev = { .events = events, .data.ptr = src };
+	if (epoll_ctl(reactor.epfd, EPOLL_CTL_MOD, src->fd, &ev) == -1) {
+		PFLOG(LOG_WARNING, "epoll_ctl: %m");
+	}
+}
+
+// Unregister a source from the reactor (it's up to the caller to close the fd *afterwards*).
+// NOTE: This may happen from a callback, while there are still pending events for that very source in the batch
+//       we're dispatching, so the actual release is deferred until the end of said batch.
+static void
+    reactor_del(ReactorSource* src)
+{
+	if (epoll_ctl(reactor.epfd, EPOLL_CTL_DEL, src->fd, NULL) == -1) {
+		PFLOG(LOG_WARNING, "epoll_ctl: %m");
+	}
+	src->fd           = -1;
+	src->next         = reactor.graveyard;
+	reactor.graveyard = src;
+}
+
+// Wait for events (for at most timeout ms, -1 meaning forever), and dispatch them to their sources' callbacks.
+static void
+    reactor_dispatch(int timeout)
+{
+	struct epoll_event events[REACTOR_MAX_EVENTS];
+	int                nfds = epoll_wait(reactor.epfd, events, REACTOR_MAX_EVENTS, timeout);
+	if (nfds == -1) {
+		if (errno == EINTR) {
+			return;
+		}
+		PFLOG(LOG_ERR, "Aborting: epoll_wait: %m");
+		FB_PRINT("[KFMon] epoll_wait failed ?!");
+		exit(EXIT_FAILURE);
+	}
+
+	for (int i = 0; i < nfds; i++) {
+		ReactorSource* src = (ReactorSource*) events[i].data.ptr;
+		// Skip sources that were removed by a previous callback in this batch
+		if (src->fd == -1) {
+			continue;
+		}
+		src->cb(src, events[i].events);
+	}
+
+	// Now that nothing can reference them anymore, release the sources that were removed during this batch
+	while (reactor.graveyard) {
+		ReactorSource* src = reactor.graveyard;
+		reactor.graveyard  = src->next;
+		free(src);
+	}
+}
+
+// Read all available inotify events from the file descriptor 'fd' (caller breaks on true).
+static bool
+    handle_events(int fd)
+{
+	// Some systems cannot read integer variables if they are not properly aligned.
+	// On other systems, incorrect alignment may decrease performance.
+	// Hence, the buffer used for reading from the inotify file descriptor
+	// should have the same alignment as struct inotify_event.
+	char                        buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+	const struct inotify_event* event;
+	bool                        destroyed_wd  = false;
+	bool                        was_unmounted = false;
 
 	// Loop while events can be read from inotify file descriptor.
 	for (;;) {
@@ -2031,6 +4083,7 @@ static bool
 #pragma GCC diagnostic ignored "-Wcast-align"
 			event = (const struct inotify_event*) ptr;
 #pragma GCC diagnostic pop
+			daemonStats.events++;
 
 			// Identify which of our target file we've caught an event for...
 			uint8_t watch_idx       = 0U;
@@ -2056,19 +4109,24 @@ static bool
 				watch_idx = WATCH_MAX - 1;
 			}
 
+			// While quiescent, the spawn blocker's own activity on our target files is just noise.
+			// NOTE: We keep the watches as-is (re-adding them by path would race with the blocker),
+			//       and only drop the events we'd have ignored anyway (c.f., enter_quiescent_mode).
+			if (quiescence.active && (event->mask & KFMON_QUIESCENT_IGNORED_MASK) == event->mask) {
+				continue;
+			}
+
 			// Print event type
 			if (event->mask & IN_OPEN) {
 				LOG(LOG_NOTICE, "Tripped IN_OPEN for %s", watchConfig[watch_idx].filename);
 				// Clunky detection of potential Nickel processing...
-				bool is_watch_spawned;
-				bool is_blocker_spawned;
-				pthread_mutex_lock(&ptlock);
-				is_watch_spawned   = is_watch_already_spawned(watch_idx);
-				is_blocker_spawned = is_blocker_running();
-				pthread_mutex_unlock(&ptlock);
-				bool is_spawn_blocked = are_spawns_blocked();
+				bool is_watch_spawned   = is_watch_already_spawned(watch_idx);
+				bool is_blocker_spawned = is_blocker_running();
+				bool is_spawn_blocked   = are_spawns_blocked();
 
 				if (!is_watch_spawned && !is_blocker_spawned && !is_spawn_blocked) {
+					// Get the payload off the flash while Nickel is busy with the file, and we with the DB...
+					queue_prefetch(watch_idx);
 					// Only check if we're ready to spawn something...
 					if (!is_target_processed(watch_idx, false)) {
 						// It's not processed on OPEN, flag as pending...
@@ -2090,13 +4148,9 @@ static bool
 				//       it means we can keep KFMon running while they're up,
 				//       without risking trying to spawn multiple instances of them,
 				//       in case they end up tripping their own inotify watch ;).
-				bool is_watch_spawned;
-				bool is_blocker_spawned;
-				pthread_mutex_lock(&ptlock);
-				is_watch_spawned   = is_watch_already_spawned(watch_idx);
-				is_blocker_spawned = is_blocker_running();
-				pthread_mutex_unlock(&ptlock);
-				bool is_spawn_blocked = are_spawns_blocked();
+				bool is_watch_spawned   = is_watch_already_spawned(watch_idx);
+				bool is_blocker_spawned = is_blocker_running();
+				bool is_spawn_blocked   = are_spawns_blocked();
 
 				if (!is_watch_spawned && !is_blocker_spawned && !is_spawn_blocked) {
 					// Check that our target file has already fully been processed by Nickel
@@ -2137,9 +4191,14 @@ static bool
 							    "%s is flagged as a spawn blocker, it will prevent *any* event from triggering a spawn while it is still running!",
 							    watchConfig[watch_idx].action);
 						}
-						// We're using execvp()...
+						// NOTE: argv[0] only, the actual exec goes through the resolved action (c.f., resolve_action).
 						char* const cmd[] = { watchConfig[watch_idx].action, NULL };
-						spawn(cmd, watch_idx);
+						if (spawn(cmd, watch_idx) == -1) {
+							LOG(LOG_WARNING,
+							    "Failed to launch %s for watch idx %hhu, nothing is running for it",
+							    watchConfig[watch_idx].action,
+							    watch_idx);
+						}
 					} else {
 						LOG(LOG_NOTICE,
 						    "Target icon '%s' might not have been fully processed by Nickel yet, don't launch anything.",
@@ -2161,10 +4220,7 @@ static bool
 					}
 				} else {
 					if (is_watch_spawned) {
-						pid_t spid;
-						pthread_mutex_lock(&ptlock);
-						spid = get_spawn_pid_for_watch(watch_idx);
-						pthread_mutex_unlock(&ptlock);
+						pid_t spid = get_spawn_pid_for_watch(watch_idx);
 
 						LOG(LOG_INFO,
 						    "As watch idx %hhu (%s) still has a spawned process (%ld -> %s) running, we won't be spawning another instance of it!",
@@ -2284,31 +4340,252 @@ static bool
 		}
 	}
 
-	// And we have another outer loop to break, so pass that on...
-	return destroyed_wd;
+	// And we have another outer loop to break, so pass that on...
+	return destroyed_wd;
+}
+
+// Reactor callback for our inotify fd
+static void
+    on_inotify_event(ReactorSource* src, uint32_t events)
+{
+	if (events & EPOLLIN) {
+		// Inotify events are available
+		if (handle_events(src->fd)) {
+			// Go back to the main loop if we exited early (because a watch was
+			// destroyed automatically after an unmount or an unlink, for instance)
+			reactor.leave_loop = true;
+		}
+	}
+}
+
+// Map the status keyword a v1 reply starts with to a KFMonIPCStatus
+static uint16_t
+    get_ipc_status(const char* reply, size_t len)
+{
+	// NOTE: Skip OK, replies without a status keyword are implicitly OK
+	for (uint16_t status = KFMON_IPC_OK + 1U; status < KFMON_IPC_STATUS_COUNT; status++) {
+		size_t name_len = strlen(kfmon_ipc_status_names[status]);
+		if (len >= name_len && strncmp(reply, kfmon_ipc_status_names[status], name_len) == 0 &&
+		    (len == name_len || reply[name_len] == '\n')) {
+			return status;
+		}
+	}
+
+	return KFMON_IPC_OK;
+}
+
+// Handle every complete request frame (protocol v2) we've buffered for an IPC client (caller closes on true).
+static bool
+    handle_ipc_frames(IpcClient* client)
+{
+	size_t off = 0U;
+	while (client->in_len - off >= sizeof(KFMonIPCRequest)) {
+		KFMonIPCRequest req;
+		memcpy(&req, client->in + off, sizeof(req));
+		if (req.len > KFMON_IPC_MAX_REQUEST_LEN) {
+			LOG(LOG_WARNING, "Received an oversized (%u bytes) IPC request, dropping the connection", req.len);
+			return true;
+		}
+		// Wait for the rest of it
+		if (client->in_len - off - sizeof(req) < req.len) {
+			break;
+		}
+
+		// Leave room for the reply's header, we'll fill it once we know what we replied
+		KFMonIPCReply reply = { .id = req.id };
+		size_t        msg_off;
+		if (begin_ipc_message(client, &msg_off) < 0) {
+			return true;
+		}
+		size_t hdr_off = client->out_len;
+		if (queue_ipc_reply(client, (const char*) &reply, sizeof(reply)) < 0) {
+			return true;
+		}
+		if (handle_ipc_command(client, client->in + off + sizeof(req), req.len)) {
+			return true;
+		}
+		// The frame tells the client where the payload ends, so, drop the NUL the v1 reply ends with
+		if (client->out_len > hdr_off + sizeof(reply) && client->out[client->out_len - 1U] == '\0') {
+			client->out_len--;
+		}
+		const char* payload = client->out + hdr_off + sizeof(reply);
+		reply.len           = (uint32_t) (client->out_len - hdr_off - sizeof(reply));
+		reply.status        = get_ipc_status(payload, reply.len);
+		memcpy(client->out + hdr_off, &reply, sizeof(reply));
+		end_ipc_message(client, msg_off);
+
+		off += sizeof(req) + req.len;
+	}
+
+	// Keep whatever's left of an incomplete frame for later
+	memmove(client->in, client->in + off, client->in_len - off);
+	client->in_len -= off;
+
+	return false;
+}
+
+// Handle a single request datagram (protocol v2, SOCK_SEQPACKET) of len bytes, received in an empty client->in
+// (caller closes on true).
+static bool
+    handle_ipc_datagram(IpcClient* client, size_t len)
+{
+	// We can't even tell which request this was, give up
+	if (len < sizeof(KFMonIPCRequest)) {
+		LOG(LOG_WARNING, "Received a runt (%zu bytes) IPC request datagram, dropping the connection", len);
+		return true;
+	}
+
+	KFMonIPCRequest req;
+	memcpy(&req, client->in, sizeof(req));
+	if (len <= sizeof(client->in) && req.len == len - sizeof(req)) {
+		client->in_len = len;
+		return handle_ipc_frames(client);
+	}
+
+	// Anything but exactly one whole frame is malformed, but we know where the next one starts, so, just say so.
+	LOG(LOG_WARNING,
+	    "Received a %zu bytes IPC request datagram for a %u bytes frame, discarding it",
+	    len,
+	    (uint32_t) (sizeof(req) + req.len));
+	char          buf[128];
+	int           packet_len = snprintf(buf,
+					    sizeof(buf),
+					    "ERR_MALFORMED_CMD\nEach datagram must hold exactly one frame of at most %zu bytes\n",
+					    sizeof(client->in));
+	KFMonIPCReply reply      = { .len = (uint32_t) packet_len, .id = req.id, .status = KFMON_IPC_ERR_MALFORMED_CMD };
+	size_t        msg_off;
+	if (begin_ipc_message(client, &msg_off) < 0 || queue_ipc_reply(client, (const char*) &reply, sizeof(reply)) < 0 ||
+	    queue_ipc_reply(client, buf, (size_t) packet_len) < 0) {
+		// Signal our caller to close the connection, we're not going to be able to reply anyway
+		return true;
+	}
+	end_ipc_message(client, msg_off);
+
+	return false;
 }
 
-// Handle input data from a successful IPC connection (caller breaks on true).
+// Handle input data from an IPC client, replies are queued in its output buffer (caller closes on true).
 static bool
-    handle_ipc(int data_fd)
+    handle_ipc(IpcClient* client)
 {
+	if (client->protocol >= 2U) {
+		// Framed protocol: append to what we've already got, we'll sort it out in handle_ipc_frames
+		// NOTE: On SOCK_SEQPACKET, each datagram must hold exactly one whole frame,
+		//       so it always lands in an empty buffer, and we ask for its actual size (MSG_TRUNC) to be able to tell.
+		ssize_t len;
+		do {
+			len = recv(client->fd,
+				   client->in + client->in_len,
+				   sizeof(client->in) - client->in_len,
+				   client->seqpacket ? MSG_TRUNC : 0);
+		} while (len == -1 && errno == EINTR);
+		if (len < 0) {
+			if (errno == EAGAIN) {
+				return false;
+			}
+			PFLOG(LOG_WARNING, "read: %m");
+			FB_PRINT("[KFMon] read failed ?!");
+			return true;
+		}
+		if (len == 0) {
+			// EoF, hang up once the pending replies have been flushed (any incomplete frame is lost)
+			client->closing = true;
+			return false;
+		}
+		if (client->seqpacket) {
+			return handle_ipc_datagram(client, (size_t) len);
+		}
+		client->in_len += (size_t) len;
+
+		return handle_ipc_frames(client);
+	}
+
 	// Eh, recycle PIPE_BUF, it should be more than enough for our needs.
 	char buf[PIPE_BUF] = { 0 };
 
 	// We don't actually know the size of the input data, so, best effort here.
-	ssize_t len = xread(data_fd, buf, sizeof(buf) - 1U);
+	// NOTE: Not xread, as that one would happily block in poll on EAGAIN, and we can't afford that anymore.
+	//       On SOCK_SEQPACKET, whatever doesn't fit is discarded along with the datagram,
+	//       so ask for its actual size (MSG_TRUNC) to be able to tell.
+	ssize_t len;
+	do {
+		len = recv(client->fd, buf, sizeof(buf) - 1U, client->seqpacket ? MSG_TRUNC : 0);
+	} while (len == -1 && errno == EINTR);
 	if (len < 0) {
-		// Only actual failures are left, xread handles the rest
+		if (errno == EAGAIN) {
+			// Spurious wakeup, wait for the next one
+			return false;
+		}
 		PFLOG(LOG_WARNING, "read: %m");
 		FB_PRINT("[KFMon] read failed ?!");
-		// Signal our polling to close the connection, don't retry, as we risk failing here again otherwise.
+		// Signal our caller to close the connection, don't retry, as we risk failing here again otherwise.
 		return true;
 	}
 
 	if (len == 0) {
-		// EoF, we're done, signal our polling to close the connection
+		// EoF, we're done, signal our caller to hang up (once the pending replies have been flushed)
+		client->closing = true;
+		return false;
+	}
+
+	// Don't act on a truncated command, it's not what the client asked for.
+	if ((size_t) len > sizeof(buf) - 1U) {
+		LOG(LOG_WARNING, "Received an oversized (%zd bytes) IPC command, discarding it", len);
+		int    packet_len = snprintf(
+		    buf, sizeof(buf), "ERR_MALFORMED_CMD\nCommands can't be longer than %zu bytes\n", sizeof(buf) - 1U);
+		size_t msg_off;
+		// w/ NUL
+		if (begin_ipc_message(client, &msg_off) < 0 ||
+		    queue_ipc_reply(client, buf, (size_t) (packet_len + 1)) < 0) {
+			// Signal our caller to close the connection, we're not going to be able to reply anyway
+			return true;
+		}
+		end_ipc_message(client, msg_off);
+		return false;
+	}
+
+	// The protocol switch is the only text command with a terminator,
+	// as a client may pipeline its first frames right behind it.
+	// NOTE: We only consume what we actually parsed (plus said terminator), so as not to eat into the first frame.
+	//       If anything but a terminator follows, we pass the whole thing along, and it'll be rejected as malformed.
+	//       That's always the case on SOCK_SEQPACKET, where each frame needs its own datagram.
+	size_t cmd_len = (size_t) len;
+	if (strncmp(buf, "protocol:", 9) == 0) {
+		uint8_t version = 0U;
+		int     n       = 0;
+		if (!client->seqpacket && sscanf(buf, "protocol:%hhu%n", &version, &n) == 1 && (size_t) n < (size_t) len &&
+		    (buf[n] == '\n' || buf[n] == '\0')) {
+			cmd_len = (size_t) n;
+		}
+	}
+	size_t msg_off;
+	if (begin_ipc_message(client, &msg_off) < 0 || handle_ipc_command(client, buf, cmd_len)) {
 		return true;
 	}
+	end_ipc_message(client, msg_off);
+	if (client->protocol < 2U || cmd_len + 1U >= (size_t) len) {
+		return false;
+	}
+	client->in_len = (size_t) len - cmd_len - 1U;
+	memcpy(client->in, buf + cmd_len + 1U, client->in_len);
+
+	return handle_ipc_frames(client);
+}
+
+// Handle a single IPC command (len bytes, not necessarily NUL-terminated), the reply is queued for the client.
+// (caller closes on true).
+static bool
+    handle_ipc_command(IpcClient* client, const char* data, size_t data_len)
+{
+	// Eh, recycle PIPE_BUF, it should be more than enough for our needs.
+	// NOTE: That's also where we format our replies.
+	char buf[PIPE_BUF] = { 0 };
+	if (data_len > sizeof(buf) - 1U) {
+		data_len = sizeof(buf) - 1U;
+	}
+	memcpy(buf, data, data_len);
+	ssize_t len = (ssize_t) data_len;
+	daemonStats.ipc_requests++;
 
 	// Handle the supported commands
 	if ((strncasecmp(buf, "list", 4) == 0) || (strncasecmp(buf, "gui-list", 8) == 0)) {
@@ -2316,61 +4593,18 @@ static bool
 		// Discriminate gui-list
 		bool gui = (buf[0] == 'g' || buf[0] == 'G');
 
-		// Reply with a list of active watches, format is id:basename(filename):label (separated by a LF)
-		//                                             or id:basename(filename) if the watch has no label set.
-		for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
-			if (!watchConfig[watch_idx].is_active) {
-				continue;
-			}
-
-			// If it's a gui listing, skip hidden watches
-			if (gui && watchConfig[watch_idx].hidden) {
-				continue;
-			}
-
-			// If it has a label, add it in a third field, otherwise, don't even print the extra field separator.
-			int packet_len = 0;
-			if (*watchConfig[watch_idx].label) {
-				packet_len = snprintf(buf,
-						      sizeof(buf),
-						      "%hhu:%s:%s\n",
-						      watch_idx,
-						      basename(watchConfig[watch_idx].filename),
-						      watchConfig[watch_idx].label);
-			} else {
-				packet_len = snprintf(
-				    buf, sizeof(buf), "%hhu:%s\n", watch_idx, basename(watchConfig[watch_idx].filename));
-			}
-			// Make sure we reply with that in full (w/o a NUL, we're not done yet) to the client.
-			if (send_in_full(data_fd, buf, (size_t) (packet_len)) < 0) {
-				// Only actual failures are left, so we're pretty much done
-				if (errno == EPIPE) {
-					PFLOG(LOG_WARNING, "Client closed the connection early");
-				} else {
-					PFLOG(LOG_WARNING, "send: %m");
-					FB_PRINT("[KFMon] send failed ?!");
-				}
-				// Don't retry on write failures, just signal our polling to close the connection
+		// Reply with a list of active watches (c.f., refresh_ipc_list_cache), in one go.
+		refresh_ipc_list_cache();
+		if (gui) {
+			if (queue_ipc_reply(client, ipcListCache.gui_list, ipcListCache.gui_list_len) < 0) {
+				// Signal our caller to close the connection, we're not going to be able to reply anyway
 				return true;
 			}
-			// NOTE: In debug mode, add a delay to test handling of replies split across multiple reads in clients...
-#ifdef DEBUG
-			const struct timespec zzz = { 0L, 250000000L };
-			nanosleep(&zzz, NULL);
-#endif
-		}
-		// Now that we're done, send a final NUL, just to be nice.
-		buf[0] = '\0';
-		if (send_in_full(data_fd, buf, 1U) < 0) {
-			// Only actual failures are left, so we're pretty much done
-			if (errno == EPIPE) {
-				PFLOG(LOG_WARNING, "Client closed the connection early");
-			} else {
-				PFLOG(LOG_WARNING, "send: %m");
-				FB_PRINT("[KFMon] send failed ?!");
+		} else {
+			if (queue_ipc_reply(client, ipcListCache.list, ipcListCache.list_len) < 0) {
+				// Signal our caller to close the connection, we're not going to be able to reply anyway
+				return true;
 			}
-			// Don't retry on write failures, just signal our polling to close the connection
-			return true;
 		}
 	} else if ((strncmp(buf, "start", 5) == 0) || (strncmp(buf, "force-start", 11) == 0) ||
 		   (strncmp(buf, "trigger", 7) == 0) || (strncmp(buf, "force-trigger", 13) == 0)) {
@@ -2399,7 +4633,7 @@ static bool
 		// We'll add a courtesy reply with the status
 		// NOTE: Actually replying something is *mandatory* in our little IPC "protocol",
 		//       as failing to get a reply in time is the only way a client can figure out that KFMon
-		//       is already busy with a previous IPC connection...
+		//       is wedged (or that we've turned it away because we're already serving too many clients)...
 		int packet_len = 0;
 		if (n == 1) {
 			// Got it! Now check if it's valid...
@@ -2455,13 +4689,9 @@ static bool
 				}
 
 				// See handle_events for the logic behind spawn blocking & co.
-				bool is_watch_spawned;
-				bool is_blocker_spawned;
-				pthread_mutex_lock(&ptlock);
-				is_watch_spawned   = is_watch_already_spawned(watch_id);
-				is_blocker_spawned = is_blocker_running();
-				pthread_mutex_unlock(&ptlock);
-				bool is_spawn_blocked = are_spawns_blocked();
+				bool is_watch_spawned   = is_watch_already_spawned(watch_id);
+				bool is_blocker_spawned = is_blocker_running();
+				bool is_spawn_blocked   = are_spawns_blocked();
 
 				// Can't force something that is itself a spawn blocker...
 				if (force && watchConfig[watch_id].block_spawns) {
@@ -2484,16 +4714,16 @@ static bool
 						    "%s is flagged as a spawn blocker, it will prevent *any* event from triggering a spawn while it is still running!",
 						    watchConfig[watch_id].action);
 					}
-					// We're using execvp()...
+					// NOTE: argv[0] only, the actual exec goes through the resolved action (c.f., resolve_action).
 					char* const cmd[] = { watchConfig[watch_id].action, NULL };
-					spawn(cmd, watch_id);
-					packet_len = snprintf(buf, sizeof(buf), "OK\n");
+					if (spawn(cmd, watch_id) == -1) {
+						packet_len = snprintf(buf, sizeof(buf), "ERR_SPAWN_FAILED\n%m\n");
+					} else {
+						packet_len = snprintf(buf, sizeof(buf), "OK\n");
+					}
 				} else {
 					if (is_watch_spawned) {
-						pid_t spid;
-						pthread_mutex_lock(&ptlock);
-						spid = get_spawn_pid_for_watch(watch_id);
-						pthread_mutex_unlock(&ptlock);
+						pid_t spid = get_spawn_pid_for_watch(watch_id);
 
 						LOG(LOG_INFO,
 						    "As watch idx %hhu (%s) still has a spawned process (%ld -> %s) running, we won't be spawning another instance of it!",
@@ -2550,31 +4780,164 @@ static bool
 		}
 
 		// Reply with the status (w/ NUL)
-		if (send_in_full(data_fd, buf, (size_t) (packet_len + 1)) < 0) {
-			// Only actual failures are left, so we're pretty much done
-			if (errno == EPIPE) {
-				PFLOG(LOG_WARNING, "Client closed the connection early");
+		if (queue_ipc_reply(client, buf, (size_t) (packet_len + 1)) < 0) {
+			// Signal our caller to close the connection, we're not going to be able to reply anyway
+			return true;
+		}
+	} else if (strncmp(buf, "status", 6) == 0) {
+		LOG(LOG_INFO, "Processing IPC status request");
+
+		// Reply with the daemon-wide status, then one line per watch slot in use (c.f., format_watch_status)
+		int packet_len = format_daemon_status(buf, sizeof(buf));
+		if (packet_len > 0 && queue_ipc_reply(client, buf, (size_t) packet_len) < 0) {
+			// Signal our caller to close the connection, we're not going to be able to reply anyway
+			return true;
+		}
+		for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
+			// Skip empty slots (a released slot keeps its history until it's handed to a new watch, though)
+			if (!watchConfig[watch_idx].is_active && !spawnStats[watch_idx].has_exited &&
+			    !is_watch_already_spawned(watch_idx)) {
+				continue;
+			}
+
+			packet_len = format_watch_status(watch_idx, buf, sizeof(buf));
+			if (packet_len > 0 && queue_ipc_reply(client, buf, (size_t) packet_len) < 0) {
+				// Signal our caller to close the connection, we're not going to be able to reply anyway
+				return true;
+			}
+		}
+		// Now that we're done, send a final NUL, just to be nice.
+		if (queue_ipc_reply(client, "", 1U) < 0) {
+			// Signal our caller to close the connection, we're not going to be able to reply anyway
+			return true;
+		}
+	} else if (strncmp(buf, "stats", 5) == 0) {
+		// Either for a specific watch, or for every active watch
+		uint8_t watch_id = WATCH_MAX;
+		if (buf[5] == ':' && (sscanf(buf, "stats:%hhu", &watch_id) != 1 || watch_id >= WATCH_MAX ||
+				      !watchConfig[watch_id].is_active)) {
+			LOG(LOG_WARNING, "Received a request for the stats of an invalid watch: %.*s", (int) len, buf);
+			// Terminated by the final NUL, below
+			int packet_len = snprintf(buf, sizeof(buf), "ERR_INVALID_ID\n");
+			if (queue_ipc_reply(client, buf, (size_t) packet_len) < 0) {
+				// Signal our caller to close the connection, we're not going to be able to reply anyway
+				return true;
+			}
+		} else {
+			LOG(LOG_INFO, "Processing IPC stats request");
+
+			// Reply with one line per watch, format is id:basename(filename):runs=N metric=last/min/max/mean ...
+			for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
+				if (!watchConfig[watch_idx].is_active) {
+					continue;
+				}
+				if (watch_id != WATCH_MAX && watch_idx != watch_id) {
+					continue;
+				}
+
+				int packet_len = format_spawn_stats(watch_idx, buf, sizeof(buf));
+				if (packet_len < 0) {
+					continue;
+				}
+				// Queue that (w/o a NUL, we're not done yet) for the client.
+				if (queue_ipc_reply(client, buf, (size_t) packet_len) < 0) {
+					// Signal our caller to close the connection, we're not going to be able to reply anyway
+					return true;
+				}
+			}
+		}
+		// Now that we're done, send a final NUL, just to be nice.
+		buf[0] = '\0';
+		if (queue_ipc_reply(client, buf, 1U) < 0) {
+			// Signal our caller to close the connection, we're not going to be able to reply anyway
+			return true;
+		}
+	} else if (strncmp(buf, "prewarm", 7) == 0) {
+		// Pull the id out of there
+		uint8_t watch_id = WATCH_MAX;
+		int     n        = sscanf(buf, "prewarm:%hhu", &watch_id);
+
+		int packet_len = 0;
+		if (n == 1) {
+			if (watch_id >= WATCH_MAX || !watchConfig[watch_id].is_active) {
+				LOG(LOG_WARNING, "Received a request to prewarm an invalid watch idx %hhu", watch_id);
+				packet_len = snprintf(buf, sizeof(buf), "ERR_INVALID_ID\n");
+			} else if (queue_prefetch(watch_id)) {
+				LOG(LOG_INFO,
+				    "Processing IPC request to prewarm watch idx %hhu (%s)",
+				    watch_id,
+				    watchConfig[watch_id].filename);
+				packet_len = snprintf(buf, sizeof(buf), "OK\n");
 			} else {
-				PFLOG(LOG_WARNING, "send: %m");
-				FB_PRINT("[KFMon] send failed ?!");
+				LOG(LOG_NOTICE, "Received a request to prewarm watch idx %hhu, which has nothing to prefetch", watch_id);
+				packet_len = snprintf(buf, sizeof(buf), "WARN_NO_PREFETCH\n");
+			}
+		} else {
+			LOG(LOG_WARNING, "Malformed prewarm command: %.*s", (int) len, buf);
+			packet_len = snprintf(buf, sizeof(buf), "ERR_MALFORMED_CMD\nExpected format is prewarm:id\n");
+		}
+
+		// Reply with the status (w/ NUL)
+		if (queue_ipc_reply(client, buf, (size_t) (packet_len + 1)) < 0) {
+			// Signal our caller to close the connection, we're not going to be able to reply anyway
+			return true;
+		}
+	} else if (strncmp(buf, "subscribe", 9) == 0) {
+		identify_ipc_client(client);
+		LOG(LOG_INFO,
+		    "IPC client PID %ld (%s) subscribed to events",
+		    (long) client->ucred.pid,
+		    client->pname);
+		int packet_len = snprintf(buf, sizeof(buf), "OK\n");
+
+		// Reply with the status (w/ NUL)
+		if (queue_ipc_reply(client, buf, (size_t) (packet_len + 1)) < 0) {
+			// Signal our caller to close the connection, we're not going to be able to reply anyway
+			return true;
+		}
+		// NOTE: Events only start flowing *after* that reply.
+		client->subscribed = true;
+	} else if (strncmp(buf, "protocol", 8) == 0) {
+		uint8_t version = 0U;
+		int     end     = 0;
+		int     n       = sscanf(buf, "protocol:%hhu%n", &version, &end);
+
+		int packet_len = 0;
+		// NOTE: buf is NUL-padded, and a trailing terminator is fine, anything else isn't (c.f., handle_ipc).
+		if (n != 1 || (buf[end] != '\0' && (buf[end] != '\n' || end + 1 != len))) {
+			LOG(LOG_WARNING, "Malformed protocol command: %.*s", (int) len, buf);
+			packet_len = snprintf(buf, sizeof(buf), "ERR_MALFORMED_CMD\nExpected format is protocol:version\n");
+			version    = client->protocol;
+		} else if (version == client->protocol ||
+			   (version == KFMON_IPC_PROTOCOL_VERSION && client->protocol < KFMON_IPC_PROTOCOL_VERSION)) {
+			if (version != client->protocol) {
+				LOG(LOG_INFO, "Switching IPC connection to protocol version %hhu", version);
 			}
-			// Don't retry on write failures, just signal our polling to close the connection
+			packet_len = snprintf(buf, sizeof(buf), "OK\n");
+		} else {
+			// NOTE: There's no going back to the unframed protocol, either.
+			LOG(LOG_WARNING, "Received a request to switch to an unsupported IPC protocol version %hhu", version);
+			packet_len = snprintf(buf,
+					      sizeof(buf),
+					      "ERR_UNSUPPORTED_PROTOCOL\nThis connection can only be switched to version %d\n",
+					      KFMON_IPC_PROTOCOL_VERSION);
+			version    = client->protocol;
+		}
+
+		// Reply with the status (w/ NUL)
+		if (queue_ipc_reply(client, buf, (size_t) (packet_len + 1)) < 0) {
+			// Signal our caller to close the connection, we're not going to be able to reply anyway
 			return true;
 		}
+		// NOTE: The switch only happens *after* that reply, which is still sent using the current protocol.
+		client->protocol = version;
 	} else if (strncasecmp(buf, "version", 7) == 0) {
 		// Reply with KFMon's short version string.
 		int packet_len = snprintf(buf, sizeof(buf), "KFMon %s\n", KFMON_VERSION);
 
 		// w/ NUL
-		if (send_in_full(data_fd, buf, (size_t) (packet_len + 1)) < 0) {
-			// Only actual failures are left, so we're pretty much done
-			if (errno == EPIPE) {
-				PFLOG(LOG_WARNING, "Client closed the connection early");
-			} else {
-				PFLOG(LOG_WARNING, "send: %m");
-				FB_PRINT("[KFMon] send failed ?!");
-			}
-			// Don't retry on write failures, just signal our polling to close the connection
+		if (queue_ipc_reply(client, buf, (size_t) (packet_len + 1)) < 0) {
+			// Signal our caller to close the connection, we're not going to be able to reply anyway
 			return true;
 		}
 	} else if (strncasecmp(buf, "full-version", 12) == 0) {
@@ -2589,15 +4952,8 @@ static bool
 					  fbink_version());
 
 		// w/ NUL
-		if (send_in_full(data_fd, buf, (size_t) (packet_len + 1)) < 0) {
-			// Only actual failures are left, so we're pretty much done
-			if (errno == EPIPE) {
-				PFLOG(LOG_WARNING, "Client closed the connection early");
-			} else {
-				PFLOG(LOG_WARNING, "send: %m");
-				FB_PRINT("[KFMon] send failed ?!");
-			}
-			// Don't retry on write failures, just signal our polling to close the connection
+		if (queue_ipc_reply(client, buf, (size_t) (packet_len + 1)) < 0) {
+			// Signal our caller to close the connection, we're not going to be able to reply anyway
 			return true;
 		}
 	} else {
@@ -2606,18 +4962,11 @@ static bool
 		int packet_len = snprintf(
 		    buf,
 		    sizeof(buf),
-		    "ERR_INVALID_CMD\nComma separated list of valid commands: version, full-version, list, gui-list, start, force-start, trigger, force-trigger\n");
+		    "ERR_INVALID_CMD\nComma separated list of valid commands: version, full-version, list, gui-list, start, force-start, trigger, force-trigger, prewarm, stats, status, protocol, subscribe\n");
 
 		// w/ NUL
-		if (send_in_full(data_fd, buf, (size_t) (packet_len + 1)) < 0) {
-			// Only actual failures are left, so we're pretty much done
-			if (errno == EPIPE) {
-				PFLOG(LOG_WARNING, "Client closed the connection early");
-			} else {
-				PFLOG(LOG_WARNING, "send: %m");
-				FB_PRINT("[KFMon] send failed ?!");
-			}
-			// Don't retry on write failures, just signal our polling to close the connection
+		if (queue_ipc_reply(client, buf, (size_t) (packet_len + 1)) < 0) {
+			// Signal our caller to close the connection, we're not going to be able to reply anyway
 			return true;
 		}
 	}
@@ -2626,29 +4975,144 @@ static bool
 	return false;
 }
 
-// Dirty little helper to pull the command name for a specific PID from procfs
-// Inspired by https://gist.github.com/fclairamb/a16a4237c46440bdb172
-static void
-    get_process_name(const pid_t pid, char* name)
-{
-	char procfile[PATH_MAX];
-	snprintf(procfile, sizeof(procfile), "/proc/%ld/comm", (long) pid);
-	FILE* f = fopen(procfile, "re");
-	if (f) {
-		size_t size = fread(name, sizeof(*name), 16U - 1U, f);
-		fclose(f);
-		if (size > 0) {
-			// Strip trailing LF
-			if (name[size - 1U] == '\n') {
-				name[size - 1U] = '\0';
+// Dirty little helper to pull the command name for a specific PID from procfs
+// Inspired by https://gist.github.com/fclairamb/a16a4237c46440bdb172
+static void
+    get_process_name(const pid_t pid, char* name)
+{
+	char procfile[PATH_MAX];
+	snprintf(procfile, sizeof(procfile), "/proc/%ld/comm", (long) pid);
+	FILE* f = fopen(procfile, "re");
+	if (f) {
+		size_t size = fread(name, sizeof(*name), 16U - 1U, f);
+		fclose(f);
+		if (size > 0) {
+			// Strip trailing LF
+			if (name[size - 1U] == '\n') {
+				name[size - 1U] = '\0';
+			}
+			// NUL terminate
+			char* end = name + size;
+			*end      = '\0';
+		}
+	} else {
+		// comm is 16 bytes
+		str5cpy(name, 16U, "<!>", 16U, TRUNC);
+	}
+}
+
+// Look for id in a cache, and copy its name if we've got it (name is 32 bytes).
+static bool
+    lookup_id_cache(const IdCacheEntry* cache, uint32_t id, char* name)
+{
+	if (idCache.inotify_fd == -1) {
+		return false;
+	}
+
+	for (uint8_t i = 0U; i < ID_CACHE_SIZE; i++) {
+		if (cache[i].valid && cache[i].id == id) {
+			str5cpy(name, 32, cache[i].name, 32, TRUNC);
+			return true;
+		}
+	}
+	return false;
+}
+
+// Remember the name of id in a cache, evicting the oldest entry if need be.
+static void
+    store_id_cache(IdCacheEntry* cache, uint8_t* next, uint32_t id, const char* name)
+{
+	if (idCache.inotify_fd == -1) {
+		return;
+	}
+
+	IdCacheEntry* entry = &cache[*next];
+	*next               = (uint8_t) ((*next + 1U) % ID_CACHE_SIZE);
+	entry->id           = id;
+	str5cpy(entry->name, sizeof(entry->name), name, 32, TRUNC);
+	entry->valid = true;
+}
+
+// Forget everything a cache knows.
+static void
+    flush_id_cache(IdCacheEntry* cache)
+{
+	for (uint8_t i = 0U; i < ID_CACHE_SIZE; i++) {
+		cache[i].valid = false;
+	}
+}
+
+// Setup the inotify watch that keeps our uid/gid caches honest.
+// Returns 0 on success, -1 on failure (in which case the caches are simply left disabled).
+static int
+    init_id_cache(void)
+{
+	int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (fd == -1) {
+		PFLOG(LOG_WARNING, "inotify_init1: %m");
+		return -1;
+	}
+
+	// NOTE: Watch the directory, as these files are usually replaced (i.e., renamed over) rather than written to.
+	if (inotify_add_watch(fd, "/etc", IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE) == -1) {
+		PFLOG(LOG_WARNING, "inotify_add_watch: %m");
+		close(fd);
+		return -1;
+	}
+
+	idCache.src = reactor_add(fd, EPOLLIN, on_id_cache_event, NULL);
+	if (idCache.src == NULL) {
+		close(fd);
+		return -1;
+	}
+	idCache.inotify_fd = fd;
+
+	return 0;
+}
+
+// Reactor callback for our /etc inotify instance, flushes the relevant cache when passwd or group change.
+static void
+    on_id_cache_event(ReactorSource* src, uint32_t events __attribute__((unused)))
+{
+	char                        buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+	const struct inotify_event* event;
+
+	while (1) {
+		ssize_t len = read(src->fd, buf, sizeof(buf));
+		if (len == -1) {
+			if (errno == EINTR) {
+				continue;
+			}
+			if (errno != EAGAIN) {
+				PFLOG(LOG_WARNING, "read: %m");
+			}
+			break;
+		}
+		if (len <= 0) {
+			break;
+		}
+
+		for (char* ptr = buf; ptr < buf + len; ptr += sizeof(struct inotify_event) + event->len) {
+			event = (const struct inotify_event*) ptr;
+			// If we lost track, we can't tell which one changed, so, flush both.
+			if (event->mask & IN_Q_OVERFLOW) {
+				LOG(LOG_WARNING, "Lost track of changes to /etc, flushing the uid & gid caches");
+				flush_id_cache(idCache.users);
+				flush_id_cache(idCache.groups);
+				continue;
+			}
+			if (event->len == 0U) {
+				continue;
+			}
+
+			if (strcmp(event->name, "passwd") == 0) {
+				DBGLOG("/etc/passwd changed, flushing the uid cache");
+				flush_id_cache(idCache.users);
+			} else if (strcmp(event->name, "group") == 0) {
+				DBGLOG("/etc/group changed, flushing the gid cache");
+				flush_id_cache(idCache.groups);
 			}
-			// NUL terminate
-			char* end = name + size;
-			*end      = '\0';
 		}
-	} else {
-		// comm is 16 bytes
-		str5cpy(name, 16U, "<!>", 16U, TRUNC);
 	}
 }
 
@@ -2657,6 +5121,10 @@ static void
 static void
     get_user_name(const uid_t uid, char* name)
 {
+	if (lookup_id_cache(idCache.users, (uint32_t) uid, name)) {
+		return;
+	}
+
 	size_t   bufsize;
 	long int rc = sysconf(_SC_GETPW_R_SIZE_MAX);
 	if (rc == -1) {
@@ -2678,10 +5146,13 @@ static void
 			errno = s;
 			PFLOG(LOG_WARNING, "getpwnam_r: %m");
 			str5cpy(name, 32, "<!>", 32, TRUNC);
+			// Don't remember failures
+			return;
 		}
 	} else {
 		str5cpy(name, 32, pwd.pw_name, 32, TRUNC);
 	}
+	store_id_cache(idCache.users, &idCache.next_user, (uint32_t) uid, name);
 }
 
 // Do the getgrgid_r dance and then just store the name
@@ -2689,6 +5160,10 @@ static void
 static void
     get_group_name(const gid_t gid, char* name)
 {
+	if (lookup_id_cache(idCache.groups, (uint32_t) gid, name)) {
+		return;
+	}
+
 	size_t   bufsize;
 	long int rc = sysconf(_SC_GETGR_R_SIZE_MAX);
 	if (rc == -1) {
@@ -2710,152 +5185,536 @@ static void
 			errno = s;
 			PFLOG(LOG_WARNING, "getgrgid_r: %m");
 			str5cpy(name, 32, "<!>", 32, TRUNC);
+			// Don't remember failures
+			return;
 		}
 	} else {
 		str5cpy(name, 32, grp.gr_name, 32, TRUNC);
 	}
+	store_id_cache(idCache.groups, &idCache.next_group, (uint32_t) gid, name);
 }
 
-// Handle a connection attempt on socket 'conn_fd'.
+// Lookup the command name & user/group names of an IPC client's peer, once, and only when something actually logs them.
 static void
-    handle_connection(int conn_fd)
+    identify_ipc_client(IpcClient* client)
 {
-	// Much like handle_events, we need to ensure fb state is consistent...
-	pthread_mutex_lock(&ptlock);
-	if (unlikely(fbink_reinit(FBFD_AUTO, &fbinkConfig) < 0)) {
-		PFLOG(LOG_WARNING, "fbink_reinit: failure");
+	if (client->identified) {
+		return;
 	}
-	pthread_mutex_unlock(&ptlock);
 
-	int data_fd = -1;
-	// NOTE: The data fd doesn't inherit the connection socket's flags on Linux.
-	do {
-		data_fd = accept(conn_fd, NULL, NULL);
-	} while (data_fd == -1 && errno == EINTR);
-	if (data_fd == -1) {
-		if (errno == EAGAIN || errno == ECONNABORTED) {
-			// Return early, and let the socket polling trigger a retry or wait for the next connection.
-			// NOTE: That seems to be the right call for ECONNABORTED, too.
-			//       c.f., Go's Accept() wrapper in src/internal/poll/fd_unix.go
-			return;
-		}
-		PFLOG(LOG_ERR, "Aborting: accept: %m");
-		FB_PRINT("[KFMon] accept failed ?!");
+	// Pull the command name from procfs
+	get_process_name(client->ucred.pid, client->pname);
+	// Lookup UID & GID
+	get_user_name(client->ucred.uid, client->uname);
+	get_group_name(client->ucred.gid, client->gname);
+	client->identified = true;
+}
+
+// Create, bind & listen to an IPC socket of the requested type at path.
+// Returns the socket's fd, aborts on failure.
+static int
+    setup_ipc_socket(const char* path, int type)
+{
+	// NOTE: We want it non-blocking because we handle incoming connections via our event loop,
+	//       and CLOEXEC not to pollute our spawns.
+	int conn_fd = socket(AF_UNIX, type | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (conn_fd == -1) {
+		PFLOG(LOG_ERR, "Failed to create IPC socket (socket: %m), aborting!");
+		exit(EXIT_FAILURE);
+	}
+
+	struct sockaddr_un sock_name = { 0 };
+	sock_name.sun_family         = AF_UNIX;
+	str5cpy(sock_name.sun_path, sizeof(sock_name.sun_path), path, strlen(path) + 1U, TRUNC);
+
+	// Although we should never trip an existing socket, unlink it first, just to be safe
+	unlink(path);
+	if (bind(conn_fd, (const struct sockaddr*) &sock_name, sizeof(sock_name)) == -1) {
+		PFLOG(LOG_ERR, "Failed to bind IPC socket (bind: %m), aborting!");
 		exit(EXIT_FAILURE);
 	}
-	// We'll also be poll'ing it, so we want it non-blocking, and CLOEXEC.
-	// NOTE: We have to do that manually, because accept4 wasn't implemented yet on Mk. 5 kernels...
-	//       (The manpage mentions 2.6.28, but that's the *first* implementation (i.e., on x86).
-	//       On arm, it was only implemented in 2.6.36 (Mk. 5 run on 2.6.35.3)...
-	//       c.f., ports/sysdeps/unix/sysv/linux/arm/kernel-features.h @ glibc).
-	int fdflags = fcntl(data_fd, F_GETFD, 0);
-	if (fdflags == -1) {
-		PFLOG(LOG_WARNING, "getfd fcntl: %m");
-		FB_PRINT("[KFMon] fcntl failed ?!");
-		goto cleanup;
-	}
-	if (fcntl(data_fd, F_SETFD, fdflags | FD_CLOEXEC) == -1) {
-		PFLOG(LOG_WARNING, "setfd fcntl: %m");
-		FB_PRINT("[KFMon] fcntl failed ?!");
-		goto cleanup;
-	}
-	int flflags = fcntl(data_fd, F_GETFL, 0);
-	if (flflags == -1) {
-		PFLOG(LOG_WARNING, "getfl fcntl: %m");
-		FB_PRINT("[KFMon] fcntl failed ?!");
-		goto cleanup;
-	}
-	if (fcntl(data_fd, F_SETFL, flflags | O_NONBLOCK) == -1) {
-		PFLOG(LOG_WARNING, "setfl fcntl: %m");
-		FB_PRINT("[KFMon] fcntl failed ?!");
-		goto cleanup;
-	}
-
-	// We'll want to log some information about the client
-	// c.f., https://github.com/troydhanson/network/tree/master/unixdomain/03.pass-pid
-	struct ucred ucred;
-	socklen_t    len = sizeof(ucred);
-	if (getsockopt(data_fd, SOL_SOCKET, SO_PEERCRED, &ucred, &len) == -1) {
-		PFLOG(LOG_WARNING, "getsockopt: %m");
-		FB_PRINT("[KFMon] getsockopt failed ?!");
-		goto cleanup;
+
+	// NOTE: We serve clients concurrently from our event loop, so there's no reason to keep the backlog short anymore.
+	if (listen(conn_fd, IPC_CLIENTS_MAX) == -1) {
+		PFLOG(LOG_ERR, "Failed to listen to IPC socket (listen: %m), aborting!");
+		exit(EXIT_FAILURE);
 	}
-	// Pull the command name from procfs
-	// NOTE: comm is 16 bytes on Linux
-	char pname[16] = { 0 };
-	get_process_name(ucred.pid, pname);
-	// Lookup UID & GID
-	// NOTE: Both fields are 32 bytes on Linux
-	char uname[32] = { 0 };
-	get_user_name(ucred.uid, uname);
-	char gname[32] = { 0 };
-	get_group_name(ucred.gid, gname);
 
-	// And now we have fancy logging :)
-	LOG(LOG_INFO,
-	    "Handling incoming IPC connection from PID %ld (%s) by user %s:%s",
-	    (long) ucred.pid,
-	    pname,
-	    uname,
-	    gname);
-
-	struct pollfd pfd = { 0 };
-	// Data socket
-	pfd.fd            = data_fd;
-	pfd.events        = POLLIN;
-
-	// Wait for data, for a few 15s windows, in order to drop inactive connections after a while
-	size_t retry = 0U;
+	return conn_fd;
+}
+
+// Current CLOCK_MONOTONIC_RAW time, in ms
+static long int
+    get_monotonic_ms(void)
+{
+	struct timespec now = { 0 };
+	clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+	return (now.tv_sec * 1000L) + (now.tv_nsec / 1000000L);
+}
+
+// Handle connection attempts on socket 'conn_fd' (of type 'type'), accepting as many pending clients as we can.
+static void
+    handle_connection(int conn_fd, int type)
+{
 	while (1) {
-		int poll_num = poll(&pfd, 1, 15 * 1000);
-		if (poll_num == -1) {
-			if (errno == EINTR) {
-				continue;
+		int data_fd = -1;
+		// NOTE: The data fd doesn't inherit the connection socket's flags on Linux.
+		do {
+			data_fd = accept(conn_fd, NULL, NULL);
+		} while (data_fd == -1 && errno == EINTR);
+		if (data_fd == -1) {
+			if (errno == EAGAIN || errno == ECONNABORTED) {
+				// Return early, and let the socket polling trigger a retry or wait for the next connection.
+				// NOTE: That seems to be the right call for ECONNABORTED, too.
+				//       c.f., Go's Accept() wrapper in src/internal/poll/fd_unix.go
+				return;
 			}
-			PFLOG(LOG_WARNING, "poll: %m");
-			FB_PRINT("[KFMon] poll failed ?!");
-			goto early_close;
+			PFLOG(LOG_ERR, "Aborting: accept: %m");
+			FB_PRINT("[KFMon] accept failed ?!");
+			exit(EXIT_FAILURE);
+		}
+
+		// Find a free client slot
+		uint8_t slot = 0U;
+		while (slot < IPC_CLIENTS_MAX && ipcClients[slot] != NULL) {
+			slot++;
+		}
+		if (slot == IPC_CLIENTS_MAX) {
+			// NOTE: We can't just leave it in the backlog, as the listening socket would then stay readable,
+			//       and we'd spin on it. Hang up right away, the client will report a failure, which is fair.
+			LOG(LOG_WARNING, "Already serving %d IPC clients, turning away a new connection", IPC_CLIENTS_MAX);
+			close(data_fd);
+			continue;
+		}
+
+		// We'll also be poll'ing it, so we want it non-blocking, and CLOEXEC.
+		// NOTE: We have to do that manually, because accept4 wasn't implemented yet on Mk. 5 kernels...
+		//       (The manpage mentions 2.6.28, but that's the *first* implementation (i.e., on x86).
+		//       On arm, it was only implemented in 2.6.36 (Mk. 5 run on 2.6.35.3)...
+		//       c.f., ports/sysdeps/unix/sysv/linux/arm/kernel-features.h @ glibc).
+		int fdflags = fcntl(data_fd, F_GETFD, 0);
+		if (fdflags == -1) {
+			PFLOG(LOG_WARNING, "getfd fcntl: %m");
+			FB_PRINT("[KFMon] fcntl failed ?!");
+			close(data_fd);
+			continue;
+		}
+		if (fcntl(data_fd, F_SETFD, fdflags | FD_CLOEXEC) == -1) {
+			PFLOG(LOG_WARNING, "setfd fcntl: %m");
+			FB_PRINT("[KFMon] fcntl failed ?!");
+			close(data_fd);
+			continue;
+		}
+		int flflags = fcntl(data_fd, F_GETFL, 0);
+		if (flflags == -1) {
+			PFLOG(LOG_WARNING, "getfl fcntl: %m");
+			FB_PRINT("[KFMon] fcntl failed ?!");
+			close(data_fd);
+			continue;
+		}
+		if (fcntl(data_fd, F_SETFL, flflags | O_NONBLOCK) == -1) {
+			PFLOG(LOG_WARNING, "setfl fcntl: %m");
+			FB_PRINT("[KFMon] fcntl failed ?!");
+			close(data_fd);
+			continue;
+		}
+
+		IpcClient* client = calloc(1U, sizeof(*client));
+		if (client == NULL) {
+			PFLOG(LOG_WARNING, "calloc: %m");
+			close(data_fd);
+			continue;
+		}
+		client->fd        = data_fd;
+		client->protocol  = 1U;
+		client->seqpacket = (type == SOCK_SEQPACKET);
+
+		// We'll want to log some information about the client
+		// c.f., https://github.com/troydhanson/network/tree/master/unixdomain/03.pass-pid
+		socklen_t len = sizeof(client->ucred);
+		if (getsockopt(data_fd, SOL_SOCKET, SO_PEERCRED, &client->ucred, &len) == -1) {
+			PFLOG(LOG_WARNING, "getsockopt: %m");
+			FB_PRINT("[KFMon] getsockopt failed ?!");
+			free(client);
+			close(data_fd);
+			continue;
+		}
+		// And now we have fancy logging :)
+		// NOTE: The peer's names are only looked up by the rare codepaths that log them (c.f., identify_ipc_client),
+		//       so that a connection doesn't have to go through procfs & NSS just for this.
+		LOG(LOG_INFO,
+		    "Handling incoming IPC connection from PID %ld by user %ld:%ld",
+		    (long) client->ucred.pid,
+		    (long) client->ucred.uid,
+		    (long) client->ucred.gid);
+
+		// Wait for data, but drop inactive connections after a while
+		client->src = reactor_add(data_fd, EPOLLIN, on_ipc_client, client);
+		if (client->src == NULL) {
+			LOG(LOG_WARNING, "Failed to register the IPC connection with the event loop");
+			free(client);
+			close(data_fd);
+			continue;
+		}
+		client->deadline = get_monotonic_ms() + IPC_IDLE_TIMEOUT_MS;
+		ipcClients[slot] = client;
+		daemonStats.ipc_clients++;
+	}
+}
+
+// We're done with an IPC client, close its connection and forget about it.
+static void
+    close_ipc_client(IpcClient* client)
+{
+	LOG(LOG_INFO,
+	    "Closing IPC connection from PID %ld by user %ld:%ld",
+	    (long) client->ucred.pid,
+	    (long) client->ucred.uid,
+	    (long) client->ucred.gid);
+
+	for (uint8_t i = 0U; i < IPC_CLIENTS_MAX; i++) {
+		if (ipcClients[i] == client) {
+			ipcClients[i] = NULL;
+			break;
+		}
+	}
+	reactor_del(client->src);
+	close(client->fd);
+	free(client->out);
+	free(client);
+}
+
+// Queue len bytes of reply data for an IPC client, they'll be sent as soon as its socket lets us.
+// Returns 0 on success, -1 on failure.
+static int
+    queue_ipc_reply(IpcClient* client, const char* data, size_t len)
+{
+	if (client->out_len + len > client->out_size) {
+		// Eh, recycle PIPE_BUF, most replies fit in a single one.
+		size_t size = client->out_size ? client->out_size : PIPE_BUF;
+		while (size < client->out_len + len) {
+			size <<= 1U;
+		}
+		char* out = realloc(client->out, size);
+		if (out == NULL) {
+			PFLOG(LOG_WARNING, "realloc: %m");
+			return -1;
+		}
+		client->out      = out;
+		client->out_size = size;
+	}
+	memcpy(client->out + client->out_len, data, len);
+	client->out_len += len;
+
+	return 0;
+}
+
+// Start a new message in an IPC client's output buffer, its offset is stored in msg_off.
+// NOTE: On SOCK_SEQPACKET connections, every message has to go out as a single datagram,
+//       so we keep track of where each of them ends, via a length prefix filled in by end_ipc_message.
+// Returns 0 on success, -1 on failure.
+static int
+    begin_ipc_message(IpcClient* client, size_t* msg_off)
+{
+	*msg_off           = client->out_len;
+	client->in_message = true;
+	if (!client->seqpacket) {
+		return 0;
+	}
+
+	const uint32_t len = 0U;
+	return queue_ipc_reply(client, (const char*) &len, sizeof(len));
+}
+
+// Done queuing the message started at msg_off (c.f., begin_ipc_message),
+// now's the time to queue the events that fired while we were at it.
+static void
+    end_ipc_message(IpcClient* client, size_t msg_off)
+{
+	if (client->seqpacket) {
+		const uint32_t len = (uint32_t) (client->out_len - msg_off - sizeof(len));
+		memcpy(client->out + msg_off, &len, sizeof(len));
+	}
+	client->in_message = false;
+
+	if (client->deferred_len == 0U) {
+		return;
+	}
+	// NOTE: queue_ipc_event ends up back here, so, work on a copy.
+	char   deferred[sizeof(client->deferred)];
+	size_t deferred_len = client->deferred_len;
+	memcpy(deferred, client->deferred, deferred_len);
+	client->deferred_len = 0U;
+	for (size_t off = 0U; off < deferred_len;) {
+		// One event per line
+		const char* eol       = memchr(deferred + off, '\n', deferred_len - off);
+		size_t      event_len = eol ? (size_t) (eol - (deferred + off)) + 1U : deferred_len - off;
+		if (client->subscribed && queue_ipc_event(client, deferred + off, event_len) < 0) {
+			drop_ipc_subscriber(client);
+		}
+		off += event_len;
+	}
+}
+
+// Rebuild the pre-serialized replies to list & gui-list, if the watch table was updated since we last did.
+static void
+    refresh_ipc_list_cache(void)
+{
+	if (ipcListCache.gen == watchConfigGen) {
+		return;
+	}
+
+	// Format is id:basename(filename):label (separated by a LF)
+	//        or id:basename(filename) if the watch has no label set.
+	size_t list_len = 0U;
+	size_t gui_len  = 0U;
+	for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
+		if (!watchConfig[watch_idx].is_active) {
+			continue;
+		}
+
+		// If it has a label, add it in a third field, otherwise, don't even print the extra field separator.
+		char* line     = ipcListCache.list + list_len;
+		int   line_len = 0;
+		if (*watchConfig[watch_idx].label) {
+			line_len = snprintf(line,
+					    IPC_LIST_LINE_MAX,
+					    "%hhu:%s:%s\n",
+					    watch_idx,
+					    basename(watchConfig[watch_idx].filename),
+					    watchConfig[watch_idx].label);
+		} else {
+			line_len = snprintf(
+			    line, IPC_LIST_LINE_MAX, "%hhu:%s\n", watch_idx, basename(watchConfig[watch_idx].filename));
+		}
+		if (line_len < 0) {
+			continue;
+		}
+
+		// A gui listing skips hidden watches
+		if (!watchConfig[watch_idx].hidden) {
+			memcpy(ipcListCache.gui_list + gui_len, line, (size_t) line_len);
+			gui_len += (size_t) line_len;
+		}
+		list_len += (size_t) line_len;
+	}
+	// And a final NUL, just to be nice.
+	ipcListCache.list[list_len++]    = '\0';
+	ipcListCache.gui_list[gui_len++] = '\0';
+
+	ipcListCache.list_len     = list_len;
+	ipcListCache.gui_list_len = gui_len;
+	ipcListCache.gen          = watchConfigGen;
+}
+
+// Queue a single event (len bytes, a single LF-terminated line) for a subscribed IPC client.
+// Returns 0 on success, -1 on failure.
+static int
+    queue_ipc_event(IpcClient* client, const char* event, size_t len)
+{
+	size_t msg_off;
+	if (begin_ipc_message(client, &msg_off) < 0) {
+		return -1;
+	}
+
+	if (client->protocol >= 2U) {
+		// Unsolicited, so, id 0
+		const KFMonIPCReply reply = { .len = (uint32_t) len, .status = KFMON_IPC_OK };
+		if (queue_ipc_reply(client, (const char*) &reply, sizeof(reply)) < 0 ||
+		    queue_ipc_reply(client, event, len) < 0) {
+			return -1;
+		}
+	} else {
+		// NUL-terminated, like any other v1 reply
+		if (queue_ipc_reply(client, event, len) < 0 || queue_ipc_reply(client, "", 1U) < 0) {
+			return -1;
+		}
+	}
+
+	end_ipc_message(client, msg_off);
+	return 0;
+}
+
+// Stop feeding events to a subscriber, and let expire_ipc_clients hang up on it on the next iteration of the event loop.
+static void
+    drop_ipc_subscriber(IpcClient* client)
+{
+	identify_ipc_client(client);
+	LOG(LOG_WARNING,
+	    "IPC subscriber PID %ld (%s) isn't keeping up with events, dropping it",
+	    (long) client->ucred.pid,
+	    client->pname);
+	client->subscribed = false;
+	client->deadline   = 0L;
+}
+
+// Queue an event (len bytes, a single LF-terminated line) for every subscribed IPC client.
+// NOTE: This may be called from pretty much anywhere (including while we're handling a command from a subscriber),
+//       so we never flush nor close anything from here: we just let the event loop know there's something to send.
+static void
+    notify_subscribers(const char* event, size_t len)
+{
+	for (uint8_t i = 0U; i < IPC_CLIENTS_MAX; i++) {
+		IpcClient* client = ipcClients[i];
+		if (client == NULL || !client->subscribed) {
+			continue;
+		}
+
+		// Don't let a subscriber that doesn't keep up make us queue forever
+		if (client->out_len - client->out_off > IPC_SUBSCRIBER_BACKLOG_MAX) {
+			drop_ipc_subscriber(client);
+			continue;
 		}
 
-		if (poll_num > 0) {
-			// Don't even *try* to deal with a connection that was closed by the client,
-			// as we wouldn't be able to reply to it in handle_ipc (NOSIGNAL send on closed socket -> EPIPE),
-			// just close it on our end, too, and move on.
-			// NOTE: Said client should already have reported a timeout waiting for our reply,
-			//       so we don't even try to drain its command, and just forget about it.
-			//       On the upside, that prevents said command from being triggered after a random delay.
-			if (pfd.revents & POLLHUP) {
-				PFLOG(LOG_NOTICE, "Client closed the IPC connection");
-				goto early_close;
+		// We may be in the middle of a reply to that very client (e.g., to a start command that just spawned something),
+		// in which case the event has to wait until said reply is complete (c.f., end_ipc_message).
+		if (client->in_message) {
+			// NOTE: That's a command firing more events than we ever do, so something's gone very wrong.
+			//       Dropping the subscriber beats silently losing events, or splicing them into the reply.
+			if (client->deferred_len + len > sizeof(client->deferred)) {
+				LOG(LOG_WARNING, "Too many events fired while replying to an IPC subscriber!");
+				drop_ipc_subscriber(client);
+				continue;
 			}
+			memcpy(client->deferred + client->deferred_len, event, len);
+			client->deferred_len += len;
+			continue;
+		}
 
-			// There's data to be read!
-			if (pfd.revents & POLLIN) {
-				if (handle_ipc(data_fd)) {
-					// We've successfully handled all input data, we're done!
-					break;
-				}
+		if (queue_ipc_event(client, event, len) < 0) {
+			drop_ipc_subscriber(client);
+			continue;
+		}
+		reactor_mod(client->src, EPOLLOUT);
+	}
+}
+
+// Send as much of the pending replies as the socket will take right now,
+// and update what we're waiting for on it accordingly (caller closes on true).
+static bool
+    flush_ipc_client(IpcClient* client)
+{
+	while (client->out_off < client->out_len) {
+		const char* msg     = client->out + client->out_off;
+		size_t      msg_len = client->out_len - client->out_off;
+		size_t      prefix  = 0U;
+		if (client->seqpacket) {
+			// One message at a time (c.f., begin_ipc_message)
+			uint32_t len;
+			memcpy(&len, msg, sizeof(len));
+			prefix  = sizeof(len);
+			msg    += prefix;
+			msg_len = len;
+		}
+
+		ssize_t sent;
+		do {
+			sent = send(client->fd, msg, msg_len, MSG_NOSIGNAL);
+		} while (sent == -1 && errno == EINTR);
+		if (sent == -1) {
+			if (errno == EAGAIN) {
+				// The client isn't draining its end fast enough, wait until it does.
+				// NOTE: Stop reading in the meantime, so a client that never reads can't make us queue forever.
+				reactor_mod(client->src, EPOLLOUT);
+				return false;
+			}
+			// Only actual failures are left, so we're pretty much done
+			if (errno == EPIPE || errno == ECONNRESET) {
+				PFLOG(LOG_WARNING, "Client closed the connection early");
+			} else {
+				PFLOG(LOG_WARNING, "send: %m");
+				FB_PRINT("[KFMon] send failed ?!");
 			}
+			// Don't retry on write failures, just signal our caller to close the connection
+			return true;
 		}
+		// NOTE: Datagrams are sent whole, or not at all.
+		client->out_off += prefix + (size_t) sent;
+	}
+
+	// Everything went through, rewind the buffer
+	client->out_off = 0U;
+	client->out_len = 0U;
+	if (client->closing) {
+		// EoF, and nothing left to say, we're done
+		return true;
+	}
+	// Go back to waiting for the next command
+	reactor_mod(client->src, EPOLLIN);
+	return false;
+}
 
-		if (poll_num == 0) {
-			// Timed out, increase the retry counter
-			retry++;
+// Drop the IPC clients whose deadline has passed.
+// Returns how long (in ms) the event loop can sleep before the next deadline, -1 meaning forever.
+static int
+    expire_ipc_clients(void)
+{
+	long int now     = get_monotonic_ms();
+	long int timeout = -1;
+	for (uint8_t i = 0U; i < IPC_CLIENTS_MAX; i++) {
+		IpcClient* client = ipcClients[i];
+		// NOTE: Subscribers are expected to sit idle, they're only dropped if they stop draining their events.
+		if (client == NULL || client->subscribed) {
+			continue;
 		}
 
-		// Drop the axe after 60s.
-		if (retry >= 4) {
+		if (now >= client->deadline) {
 			LOG(LOG_NOTICE, "Dropping inactive IPC connection");
-			goto early_close;
+			close_ipc_client(client);
+			continue;
+		}
+		if (timeout == -1 || client->deadline - now < timeout) {
+			timeout = client->deadline - now;
+		}
+	}
+
+	return (int) timeout;
+}
+
+// Reactor callback for our IPC socket
+static void
+    on_ipc_connection(ReactorSource* src, uint32_t events)
+{
+	if (events & EPOLLIN) {
+		// There was a new connection attempt (our data is the socket's type)
+		handle_connection(src->fd, (int) (uintptr_t) src->data);
+	}
+}
+
+// Reactor callback for an IPC client's data socket
+static void
+    on_ipc_client(ReactorSource* src, uint32_t events)
+{
+	IpcClient* client = (IpcClient*) src->data;
+
+	// Don't even *try* to deal with a connection that was closed by the client,
+	// as we wouldn't be able to reply to it anyway (NOSIGNAL send on closed socket -> EPIPE),
+	// just close it on our end, too, and move on.
+	// NOTE: Said client should already have reported a timeout waiting for our reply,
+	//       so we don't even try to drain its command, and just forget about it.
+	//       On the upside, that prevents said command from being triggered after a random delay.
+	if (events & (EPOLLHUP | EPOLLERR)) {
+		PFLOG(LOG_NOTICE, "Client closed the IPC connection");
+		close_ipc_client(client);
+		return;
+	}
+
+	// There's data to be read!
+	if (events & EPOLLIN) {
+		if (handle_ipc(client)) {
+			close_ipc_client(client);
+			return;
 		}
 	}
 
-early_close:
-	// We're done, close the data connection
-	LOG(LOG_INFO, "Closing IPC connection from PID %ld (%s) by user %s:%s", (long) ucred.pid, pname, uname, gname);
+	// Whether we just queued a reply, or the socket can take some more of an earlier one, try to send it.
+	if (flush_ipc_client(client)) {
+		close_ipc_client(client);
+		return;
+	}
 
-cleanup:
-	close(data_fd);
+	// The client is still alive and kicking, give it some more time
+	client->deadline = get_monotonic_ms() + IPC_IDLE_TIMEOUT_MS;
 }
 
 // Handle SQLite logging on error
@@ -2933,6 +5792,9 @@ static bool
 int
     main(int argc __attribute__((unused)), char* argv[] __attribute__((unused)))
 {
+	// For our uptime (c.f., format_daemon_status)
+	daemonStats.start_ms = get_monotonic_ms();
+
 	// Make sure we're running at a neutral niceness
 	// (e.g., being launched via udev would leave us with a negative nice value).
 	if (setpriority(PRIO_PROCESS, 0, 0) == -1) {
@@ -2981,6 +5843,11 @@ int
 		openlog("kfmon", LOG_CONS | LOG_PID | LOG_NDELAY, LOG_DAEMON);
 	}
 
+#ifdef KFMON_SPAWN_HELPER
+	// Fork our spawn helper while we're still small
+	start_spawn_helper();
+#endif
+
 	// Initialize the process table, to track our spawns
 	init_process_table();
 
@@ -2995,6 +5862,8 @@ int
 	// We'll also need the state to handle device detection.
 	// That's the only thing we need it for, which is why we don't refresh it on reinit.
 	fbink_get_state(&fbinkConfig, &fbinkState);
+	// Take our initial fb snapshot, so the first print doesn't needlessly trigger a reinit.
+	has_fb_state_changed();
 	// On sunxi, enforce UR for the early boot welcome message.
 	if (fbinkState.is_sunxi) {
 		if (fbink_sunxi_ntx_enforce_rota(FBFD_AUTO, FORCE_ROTA_UR, &fbinkConfig) < 0) {
@@ -3012,31 +5881,37 @@ int
 		exit(EXIT_FAILURE);
 	}
 
-	// Setup the IPC socket
-	// NOTE: We want it non-blocking because we handle incoming connections via poll,
-	//       and CLOEXEC not to pollute our spawns.
-	int conn_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
-	if (conn_fd == -1) {
-		PFLOG(LOG_ERR, "Failed to create IPC socket (socket: %m), aborting!");
+	// Setup the IPC sockets: the historical SOCK_STREAM one,
+	// and a SOCK_SEQPACKET one, which preserves message boundaries (both talk the same protocol).
+	int conn_fd = setup_ipc_socket(KFMON_IPC_SOCKET, SOCK_STREAM);
+	int seq_fd  = setup_ipc_socket(KFMON_IPC_SEQPACKET_SOCKET, SOCK_SEQPACKET);
+
+	// Setup our event loop, which the IPC socket will be a permanent fixture of.
+	if (reactor_init() == -1) {
+		LOG(LOG_ERR, "Failed to setup the event loop, aborting!");
 		exit(EXIT_FAILURE);
 	}
-
-	struct sockaddr_un sock_name = { 0 };
-	sock_name.sun_family         = AF_UNIX;
-	str5cpy(sock_name.sun_path, sizeof(sock_name.sun_path), KFMON_IPC_SOCKET, sizeof(KFMON_IPC_SOCKET), TRUNC);
-
-	// Although we should never trip an existing socket, unlink it first, just to be safe
-	unlink(KFMON_IPC_SOCKET);
-	if (bind(conn_fd, (const struct sockaddr*) &sock_name, sizeof(sock_name)) == -1) {
-		PFLOG(LOG_ERR, "Failed to bind IPC socket (bind: %m), aborting!");
+	ReactorSource* conn_src = reactor_add(conn_fd, EPOLLIN, on_ipc_connection, (void*) (uintptr_t) SOCK_STREAM);
+	ReactorSource* seq_src  = reactor_add(seq_fd, EPOLLIN, on_ipc_connection, (void*) (uintptr_t) SOCK_SEQPACKET);
+	if (conn_src == NULL || seq_src == NULL) {
+		LOG(LOG_ERR, "Failed to register the IPC sockets with the event loop, aborting!");
+		exit(EXIT_FAILURE);
+	}
+	// We'll also reap our children from there
+	if (init_reaper() == -1) {
+		LOG(LOG_ERR, "Failed to setup child process tracking, aborting!");
 		exit(EXIT_FAILURE);
 	}
+	// Publish a read-only snapshot of our state for frontends that'd rather not poll us over IPC
+	init_state_page();
+	// And keep an eye on the user & group databases, to keep our uid/gid name caches honest
+	if (init_id_cache() == -1) {
+		LOG(LOG_WARNING, "Failed to watch the user & group databases, IPC peer names won't be cached");
+	}
 
-	// NOTE: We only accept a single client, as we can only serve 'em one by one anyway.
-	//       Be aware that, in practice, the kernel will round that up, which means that you can successfully connect,
-	//       send a request, but only get a reply whenever we actually get to it...
-	if (listen(conn_fd, 1) == -1) {
-		PFLOG(LOG_ERR, "Failed to listen to IPC socket (listen: %m), aborting!");
+	// Start the prefetch thread (after the reaper, so that it inherits a blocked SIGCHLD, too)
+	if (init_prefetcher() == -1) {
+		LOG(LOG_ERR, "Failed to start the prefetch thread, aborting!");
 		exit(EXIT_FAILURE);
 	}
 
@@ -3063,7 +5938,7 @@ int
 	//       while completely broken info would only cause the MXCFB ioctl to fail, we wouldn't segfault.
 	//       (Well, to be perfectly fair, it'd take an utterly broken finfo.smem_len to crash,
 	//       and that should never happen).
-	// NOTE: To get up to date info, we'll reinit on each new batch of inotify events we catch,
+	// NOTE: To get up to date info, we'll check the fb state right before printing anything (c.f., refresh_fbink_state),
 	//       thus ensuring we'll always have an accurate snapshot of the fb state before printing messages.
 	if (daemonConfig.with_notifications) {
 		FB_PRINT("[KFMon] Successfully initialized. :)");
@@ -3109,14 +5984,6 @@ int
 	while (1) {
 		LOG(LOG_INFO, "Beginning the main loop.");
 
-		// Here, on subsequent iterations, we might be printing stuff *before* handle_events or handle_connection,
-		// (mainly in error-ish codepaths), so we need to check the fb state right now, too...
-		pthread_mutex_lock(&ptlock);
-		if (unlikely(fbink_reinit(FBFD_AUTO, &fbinkConfig) < 0)) {
-			PFLOG(LOG_WARNING, "fbink_reinit: failure");
-		}
-		pthread_mutex_unlock(&ptlock);
-
 		// Make sure our target partition is mounted
 		if (!is_target_mounted()) {
 			LOG(LOG_INFO, "%s isn't mounted, waiting for it to be . . .", KFMON_TARGET_MOUNTPOINT);
@@ -3128,11 +5995,15 @@ int
 		// NOTE: Mainly up there for clarity, otherwise it technically belongs at the end of the loop.
 		//       The only minor drawback of having it up there is that it'll run on startup.
 		//       On the upside, this ensures the update codepath will see some action, and isn't completely broken ;).
+		// NOTE: Standbys are re-armed afterwards, with the updated config.
+		disarm_standbys();
 		if (update_watch_configs() == -1) {
 			LOG(LOG_ERR, "Failed to check watch configs for updates, aborting!");
 			FB_PRINT("[KFMon] Failed to update watch configs!");
 			exit(EXIT_FAILURE);
 		}
+		resolve_actions();
+		refresh_blockers();
 
 		// Create the file descriptor for accessing the inotify API
 		LOG(LOG_INFO, "Initializing inotify.");
@@ -3167,7 +6038,7 @@ int
 			}
 
 			watchConfig[watch_idx].inotify_wd =
-			    inotify_add_watch(fd, watchConfig[watch_idx].filename, IN_OPEN | IN_CLOSE);
+			    inotify_add_watch(fd, watchConfig[watch_idx].filename, KFMON_INOTIFY_MASK);
 			if (watchConfig[watch_idx].inotify_wd == -1) {
 				// NOTE: Allow running without an actual inotify watch, keeping the action IPC only...
 				//       We could limit this behavior to !hidden watches, or hide it behind another config flag,
@@ -3194,9 +6065,7 @@ int
 					//       instead of having to reboot.
 
 					// If that watch isn't currently running, clear it entirely!
-					pthread_mutex_lock(&ptlock);
 					bool is_watch_spawned = is_watch_already_spawned(watch_idx);
-					pthread_mutex_unlock(&ptlock);
 					if (is_watch_spawned) {
 						LOG(LOG_WARNING,
 						    "Cannot release watch slot %hhu (%s => %s), as it's currently running!",
@@ -3204,10 +6073,8 @@ int
 						    basename(watchConfig[watch_idx].filename),
 						    basename(watchConfig[watch_idx].action));
 					} else {
-						watchConfig[watch_idx] = (const WatchConfig){ 0 };
-						// NOTE: This should essentially come down to:
-						//memset(&watchConfig[watch_idx], 0, sizeof(WatchConfig));
-						LOG(LOG_NOTICE, "Released watch slot %hhu.", watch_idx);
+						release_watch_slot(watch_idx);
+						NOTIFY_SUBSCRIBERS("watch:removed:%hhu", watch_idx);
 					}
 				}
 			} else {
@@ -3218,53 +6085,45 @@ int
 			}
 		}
 
-		struct pollfd pfds[2] = { 0 };
-		nfds_t        nfds    = 2;
-		// Inotify input
-		pfds[0].fd            = fd;
-		pfds[0].events        = POLLIN;
-		// Connection socket
-		pfds[1].fd            = conn_fd;
-		pfds[1].events        = POLLIN;
+		// Now that we know which watches survived, launch the standbys we need
+		arm_standbys();
+		// The config update may have changed which watches are flagged as spawn blockers
+		update_quiescent_mode();
+
+		// Register our inotify fd with the event loop
+		ReactorSource* inotify_src = reactor_add(fd, EPOLLIN, on_inotify_event, NULL);
+		if (inotify_src == NULL) {
+			LOG(LOG_ERR, "Failed to register inotify with the event loop, aborting!");
+			FB_PRINT("[KFMon] Failed to setup the event loop!");
+			exit(EXIT_FAILURE);
+		}
 
 		// Wait for events
 		LOG(LOG_INFO, "Listening for events.");
-		while (1) {
-			int poll_num = poll(pfds, nfds, -1);
-			if (poll_num == -1) {
-				if (errno == EINTR) {
-					continue;
-				}
-				PFLOG(LOG_ERR, "Aborting: poll: %m");
-				FB_PRINT("[KFMon] poll failed ?!");
-				exit(EXIT_FAILURE);
-			}
-
-			if (poll_num > 0) {
-				if (pfds[0].revents & POLLIN) {
-					// Inotify events are available
-					if (handle_events(fd)) {
-						// Go back to the main loop if we exited early (because a watch was
-						// destroyed automatically after an unmount or an unlink, for instance)
-						break;
-					}
-				}
-
-				if (pfds[1].revents & POLLIN) {
-					// There was a new connection attempt
-					handle_connection(conn_fd);
-				}
-			}
+		reactor.leave_loop = false;
+		while (!reactor.leave_loop) {
+			// Let frontends know about whatever changed during the previous round
+			publish_state_page();
+			// Only wake up on our own for the IPC clients we may have to drop
+			reactor_dispatch(expire_ipc_clients());
 		}
 		LOG(LOG_INFO, "Stopped listening for events.");
 
+		// Unregister it before we close it
+		reactor_del(inotify_src);
 		// Close inotify file descriptor
 		close(fd);
 	}
 
-	// Close the IPC connection socket. Unreachable.
+	// Close the IPC connection sockets. Unreachable.
+	reactor_del(conn_src);
+	reactor_del(seq_src);
 	close(conn_fd);
+	close(seq_fd);
+	close(reactor.epfd);
 	unlink(KFMON_IPC_SOCKET);
+	unlink(KFMON_IPC_SEQPACKET_SOCKET);
+	unlink(KFMON_STATE_PAGE);
 	// Release SQLite resources. Also unreachable ;p.
 	sqlite3_shutdown();
 	// Why, yes, this is unreachable! Good thing it's also optional ;).
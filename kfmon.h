@@ -29,24 +29,34 @@
 #include "inih/ini.h"
 #include "openssh/atomicio.h"
 #include "str5/str5.h"
+#include "utils/ipc_proto.h"
+#include "utils/state_page.h"
 #include <errno.h>
 #include <fcntl.h>
 #include <fts.h>
 #include <grp.h>
 #include <limits.h>
+#include <linux/fb.h>
 #include <linux/limits.h>
+#include <malloc.h>
 #include <mntent.h>
 #include <poll.h>
 #include <pthread.h>
 #include <pwd.h>
+#include <sched.h>
 #include <signal.h>
 #include <sqlite3.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/epoll.h>
 #include <sys/inotify.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
 #include <sys/resource.h>
+#include <sys/signalfd.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/syscall.h>
@@ -78,7 +88,9 @@ extern const char* sqlite3ErrName(int);
 // Use my debug paths on demand...
 #ifndef NILUJE
 #	define KOBO_DB_PATH     KFMON_TARGET_MOUNTPOINT "/.kobo/KoboReader.sqlite"
-#	define KFMON_LOGFILE    "/usr/local/kfmon/kfmon.log"
+#	ifndef KFMON_LOGFILE
+#		define KFMON_LOGFILE "/usr/local/kfmon/kfmon.log"
+#	endif
 #	define KFMON_CONFIGPATH KFMON_TARGET_MOUNTPOINT "/.adds/kfmon/config"
 #else
 #	define KOBO_DB_PATH     "/home/niluje/Kindle/Staging/KoboReader.sqlite"
@@ -86,11 +98,12 @@ extern const char* sqlite3ErrName(int);
 #	define KFMON_CONFIGPATH "/home/niluje/Kindle/Staging/kfmon"
 #endif
 
-// Path to our pidfile
-#define KFMON_PID_FILE "/var/run/kfmon.pid"
+// Path to our pidfile (overridable, so that a sandboxed instance (c.f., utils/ipc-bench.c) doesn't clobber it)
+#ifndef KFMON_PID_FILE
+#	define KFMON_PID_FILE "/var/run/kfmon.pid"
+#endif
 
-// Path to our IPC Unix socket
-#define KFMON_IPC_SOCKET "/tmp/kfmon-ipc.ctl"
+// NOTE: The paths to our IPC Unix sockets live in utils/ipc_proto.h, as clients need them, too.
 
 // MIN/MAX with no side-effects,
 // c.f., https://gcc.gnu.org/onlinedocs/cpp/Duplication-of-Side-Effects.html#Duplication-of-Side-Effects
@@ -180,6 +193,9 @@ extern const char* sqlite3ErrName(int);
 // For sscanf
 #define CFG_SZ_MAX_STR "128"
 
+// The prefetch key is a list, which can be spread over multiple lines (or multiple keys), so it gets more room.
+#define PREFETCH_SZ_MAX 512
+
 // What the daemon config should look like
 typedef struct
 {
@@ -188,9 +204,35 @@ typedef struct
 	bool               with_notifications;
 } DaemonConfig;
 
+// Max amount of rlimit entries per watch
+#define TUNING_RLIMITS_MAX 8
+// Scheduling & resource controls applied to an action right before it's exec'ed (c.f., spawn_child).
+// Anything left unset is simply inherited from us.
+typedef struct
+{
+	struct
+	{
+		int           resource;
+		struct rlimit rlim;
+	} rlimits[TUNING_RLIMITS_MAX];
+	// cgroup to move the action to (e.g., a cgroup v2 leaf), empty if none.
+	char     cgroup[CFG_SZ_MAX];
+	// Bitmask of allowed CPUs, 0 if unset.
+	uint32_t cpu_mask;
+	int      sched_policy;
+	int      sched_priority;
+	// Encoded like the kernel does it (class << IOPRIO_CLASS_SHIFT | data), 0 (i.e., IOPRIO_CLASS_NONE) if unset.
+	int      ioprio;
+	int      nice;
+	uint8_t  rlimits_count;
+	bool     set_sched;
+	bool     set_nice;
+} SpawnTuning;
+
 // What a watch config should look like
 typedef struct
 {
+	SpawnTuning tuning;
 	time_t processing_ts;
 	int    inotify_wd;
 	char   filename[CFG_SZ_MAX];
@@ -199,35 +241,238 @@ typedef struct
 	char   db_title[DB_SZ_MAX];
 	char   db_author[DB_SZ_MAX];
 	char   db_comment[DB_SZ_MAX];
+	// Comma-separated list of files & directories to prefetch (c.f., prefetch_thread)
+	char   prefetch[PREFETCH_SZ_MAX];
 	bool   hidden;
 	bool   skip_db_checks;
 	bool   do_db_update;
 	bool   block_spawns;
+	bool   standby;
 	bool   wd_was_destroyed;
 	bool   pending_processing;
 	bool   is_active;
+	// Dropped while its action was running: the slot stays reserved (and keeps its block_spawns flag)
+	// until that process is reaped (c.f., reap_process & update_watch_configs).
+	bool   pending_release;
 } WatchConfig;
 
 // Hardcode the max amount of watches we handle
 // NOTE: Cannot exceed INT8_MAX!
 #define WATCH_MAX 16
 
+// Our main loop is a tiny epoll-based reactor: every fd we care about is registered alongside a callback,
+// which gets called with the epoll events that fired for it.
+typedef struct reactor_source ReactorSource;
+typedef void (*reactor_cb)(ReactorSource*, uint32_t);
+struct reactor_source
+{
+	reactor_cb     cb;
+	void*          data;
+	// Only used to defer the release of sources removed while we're dispatching a batch of events.
+	ReactorSource* next;
+	// -1 once the source has been removed
+	int            fd;
+};
+// Max amount of events we handle per epoll_wait call
+#define REACTOR_MAX_EVENTS 16
+struct
+{
+	ReactorSource* graveyard;
+	int            epfd;
+	// Set by a callback to break out of the current reactor loop (e.g., when our inotify watches were destroyed).
+	bool           leave_loop;
+} reactor = { .epfd = -1 };
+static int            reactor_init(void);
+static ReactorSource* reactor_add(int, uint32_t, reactor_cb, void*);
+static void           reactor_mod(ReactorSource*, uint32_t);
+static void           reactor_del(ReactorSource*);
+static void           reactor_dispatch(int);
+
+// A mutex that keeps track of how often it was fought over.
+// NOTE: The counters are only ever updated with the lock held.
+typedef struct
+{
+	pthread_mutex_t   mutex;
+	unsigned long int acquired;
+	unsigned long int contended;
+} CountedMutex;
+#define COUNTED_MUTEX_INITIALIZER { .mutex = PTHREAD_MUTEX_INITIALIZER }
+static void counted_mutex_lock(CountedMutex*);
+static void counted_mutex_unlock(CountedMutex*);
+
+// Who owns what, thread-wise:
+// - The process table, the watch configs & the inotify/IPC plumbing all belong to the main thread,
+//   and are never touched by anything else, so they don't need any locking.
+// - The prefetch thread only works off of its own copy of a watch's prefetch list (c.f., prefetcher).
+// - FBInk's library globals (and our fb snapshot) are main-thread only, too: the prefetch thread logs via MTLOG,
+//   which never prints anything on screen, so FB_PRINT & co must never be used off the main thread.
+// - The prefetcher's queue is the only thing actually shared, so that's the only lock we have (c.f., prefetcher).
+
 // Used to keep track of our spawned processes, by storing their pids, and their watch idx.
 // c.f., https://stackoverflow.com/a/35235950 & https://stackoverflow.com/a/8976461
 // As well as issue #2 for details of past failures w/ a SIGCHLD handler
+// NOTE: Reaping is done from the main loop, so this is only ever touched by the main thread.
+// What a process table entry is up to
+typedef enum
+{
+	SPAWN_RUNNING = 0,    // A regular spawn, or a standby that has been released
+	SPAWN_STANDBY,        // A standby waiting on its gate for a trigger
+	SPAWN_DISARMED,       // A standby we've closed the gate on, pending its exit
+} __attribute__((packed)) SpawnState;
+// Max amount of processes we keep track of.
+// Every watch can have a running process and an armed standby at the same time,
+// plus the odd disarmed standby on its way out.
+// NOTE: Cannot exceed 32 (c.f., free_entries)!
+#define PT_MAX (WATCH_MAX * 2)
 struct process_table
 {
-	pid_t  spawn_pids[WATCH_MAX];
+	pid_t           spawn_pids[PT_MAX];
+	// Our end of a standby's gate (c.f., arm_standby), -1 otherwise.
+	int             spawn_gates[PT_MAX];
+	SpawnState      spawn_states[PT_MAX];
+	// The process's pidfd, when we're able to use one.
+	ReactorSource*  spawn_srcs[PT_MAX];
 	// NOTE: Needs to be signed because we use -1 as a special value meaning 'available'.
-	int8_t spawn_watchids[WATCH_MAX];
+	int8_t          spawn_watchids[PT_MAX];
+	// Whether that entry is accounted for in running_blockers
+	bool            spawn_blockers[PT_MAX];
+	// When it started running (i.e., when it was spawned, or when its standby was released), and how long it took to exec.
+	struct timespec spawn_starts[PT_MAX];
+	long int        spawn_exec_us[PT_MAX];
+	// Per-watch lookups, kept in sync by add_process_to_table, set_process_state & remove_process_from_table,
+	// so that the checks we run on every event don't have to walk the table.
+	// Index of the entry of the running process of a watch, -1 if none.
+	int8_t          running[WATCH_MAX];
+	// Index of the entry of the armed standby of a watch, -1 if none.
+	int8_t          standby[WATCH_MAX];
+	// Bitmask of available entries
+	uint32_t        free_entries;
+	// Amount of running processes from watches flagged as spawn blockers
+	uint8_t         running_blockers;
 } PT;
-pthread_mutex_t ptlock = PTHREAD_MUTEX_INITIALIZER;
 static void     init_process_table(void);
 static int8_t   get_next_available_pt_entry(void);
-static void     add_process_to_table(uint8_t, pid_t, uint8_t);
+static int8_t   get_pt_entry_for_pid(pid_t);
+static void     add_process_to_table(uint8_t, pid_t, uint8_t, SpawnState);
+static void     set_process_state(uint8_t, SpawnState);
 static void     remove_process_from_table(uint8_t);
+static void     refresh_blockers(void);
+
+// pidfd_open is fairly recent (Linux 5.3), and not exposed by older libcs...
+#ifndef SYS_pidfd_open
+#	define SYS_pidfd_open 434
+#endif
+// How we learn about our children's demise:
+// via a pidfd per child when the kernel supports it, otherwise via a signalfd for SIGCHLD.
+// (Or from our spawn helper, when there's one, since they're its children, not ours).
+struct
+{
+	ReactorSource* sigchld_src;
+	ReactorSource* helper_src;
+	bool           use_pidfd;
+} reaper = { 0 };
+static int  sys_pidfd_open(pid_t, unsigned int);
+static int  init_reaper(void);
+static void track_process(uint8_t);
+static void reap_process(uint8_t, int, const struct rusage*);
+static void on_pidfd_event(ReactorSource*, uint32_t);
+static void on_sigchld_event(ReactorSource*, uint32_t);
+
+// Per-watch resource accounting of reaped processes (c.f., account_process)
+typedef enum
+{
+	METRIC_WALL_MS = 0,    // Wall-clock runtime
+	METRIC_EXEC_US,        // Time from spawn to exec
+	METRIC_UTIME_MS,       // User CPU time
+	METRIC_STIME_MS,       // System CPU time
+	METRIC_MAXRSS_KB,      // Peak RSS
+	METRIC_MAJFLT,         // Major page faults
+	METRIC_INBLOCK,        // Block input operations
+	METRIC_OUBLOCK,        // Block output operations
+	METRIC_COUNT
+} SpawnMetric;
+static const char* spawn_metric_names[METRIC_COUNT] = { "wall_ms", "exec_us", "utime_ms", "stime_ms",
+							"maxrss_kb", "majflt",  "inblock",  "oublock" };
+typedef struct
+{
+	uint64_t last;
+	uint64_t min;
+	uint64_t max;
+	uint64_t sum;
+} MetricStats;
+typedef struct
+{
+	MetricStats metrics[METRIC_COUNT];
+	// Wall-clock time of the last launch, 0 if none
+	time_t      last_launch;
+	// wait status of the last run, only meaningful if has_exited is set
+	int         last_wstatus;
+	// errno of the last launch that failed before the exec went through, 0 if none
+	int         last_spawn_errno;
+	uint32_t    runs;
+	uint32_t    spawn_failures;
+	bool        has_exited;
+} SpawnStats;
+// NOTE: Main thread only, like the process table. Reset whenever a slot is handed to a new watch.
+SpawnStats  spawnStats[WATCH_MAX] = { 0 };
+static void update_metric_stats(MetricStats*, uint32_t, uint64_t);
+static void account_process(uint8_t, long int, const struct timespec*, const struct rusage*);
+static int  format_spawn_stats(uint8_t, char*, size_t);
+
+// Daemon-wide counters, for the status IPC command.
+// NOTE: Main thread only, too.
+struct
+{
+	MetricStats db_check_us;
+	uint64_t    events;
+	uint64_t    ipc_clients;
+	uint64_t    ipc_requests;
+	// c.f., get_monotonic_ms
+	long int    start_ms;
+	uint32_t    db_checks;
+	uint32_t    rebuilds;
+} daemonStats = { 0 };
+static int format_daemon_status(char*, size_t);
+static int format_watch_status(uint8_t, char*, size_t);
+
+// Read-only state page for frontends (c.f., utils/state_page.h).
+// NOTE: Main thread only, too. It's refreshed right before the event loop goes back to sleep.
+struct
+{
+	KFMonStatePage* page;
+	// Set whenever the process table changes (watch table changes are tracked via watchConfigGen)
+	bool            dirty;
+} statePage = { 0 };
+static void init_state_page(void);
+static void publish_state_page(void);
+#if WATCH_MAX != KFMON_STATE_WATCH_MAX || CFG_SZ_MAX != KFMON_STATE_NAME_MAX
+#	error "The state page layout is out of sync with the watch table!"
+#endif
+
+// Page-cache prefetching of an action's payload (on IN_OPEN, or via IPC), done on a dedicated thread,
+// so that the spawn on IN_CLOSE mostly hits RAM instead of the flash.
+// NOTE: Requests are queued by the main thread, one slot per watch, and the thread never touches watchConfig.
+//       Since we cap the amount of data we read ahead per request (because RAM is a rare commodity on some devices),
+//       order your prefetch list by priority.
+#define PREFETCH_MAX_BYTES (32U * 1024U * 1024U)
+struct
+{
+	CountedMutex   lock;
+	pthread_cond_t cond;
+	uint32_t       pending;
+	char           paths[WATCH_MAX][PREFETCH_SZ_MAX];
+	// The prefetch thread's kernel tid, set by the thread itself once it's up
+	pid_t          tid;
+} prefetcher = { .lock = COUNTED_MUTEX_INITIALIZER, .cond = PTHREAD_COND_INITIALIZER };
+static int    init_prefetcher(void);
+static bool   queue_prefetch(uint8_t);
+static size_t prefetch_file(int, const char*, size_t);
+static size_t prefetch_path(const char*, size_t);
+static void*  prefetch_thread(void*);
 
 static void init_fbink_config(void);
+static bool has_fb_state_changed(void);
+static void refresh_fbink_state(void);
 
 // SQLite macros inspired from http://www.lemoda.net/c/sqlite-insert/ :)
 #define CALL_SQLITE(f)                                                                                                   \
@@ -249,34 +494,80 @@ static int daemonize(void);
 static struct tm*  get_localtime(struct tm* restrict);
 static char*       format_localtime(struct tm* restrict, char* restrict, size_t);
 static char*       get_current_time(void);
-static char*       get_current_time_r(struct tm* restrict, char* restrict, size_t);
 static const char* get_log_prefix(int) __attribute__((const));
 
 static bool is_target_mounted(void);
 static void wait_for_target_mountpoint(void);
 
-static int    strtoul_hu(const char*, unsigned short int* restrict);
-static int    strtobool(const char* restrict, bool* restrict);
-static int    daemon_handler(void*, const char* restrict, const char* restrict, const char* restrict);
-static int    watch_handler(void*, const char* restrict, const char* restrict, const char* restrict);
-static bool   validate_watch_config(void*);
-static bool   validate_and_merge_watch_config(void*, uint8_t, bool*);
-static int8_t get_next_available_watch_entry(void);
-static int    fts_alphasort(const FTSENT**, const FTSENT**);
-static int    load_config(void);
-static int    update_watch_configs(void);
+static int          strtoul_hu(const char*, unsigned short int* restrict);
+static int          strtobool(const char* restrict, bool* restrict);
+static int          strtol_ranged(const char*, long int, long int, long int* restrict);
+static int          parse_nice(const char*, SpawnTuning* restrict);
+static int          parse_ioprio(const char*, SpawnTuning* restrict);
+static int          parse_sched(const char*, SpawnTuning* restrict);
+static int          parse_cpu_affinity(const char*, SpawnTuning* restrict);
+static int          strtorlim(const char*, rlim_t* restrict);
+static int          parse_rlimits(const char*, SpawnTuning* restrict);
+static bool         are_tunings_equal(const SpawnTuning* restrict, const SpawnTuning* restrict);
+static char*        format_tuning(const SpawnTuning* restrict, char* restrict, size_t);
+static int          daemon_handler(void*, const char* restrict, const char* restrict, const char* restrict);
+static int          watch_handler(void*, const char* restrict, const char* restrict, const char* restrict);
+static bool         validate_watch_config(void*, const WatchConfig*);
+static bool         validate_and_merge_watch_config(void*, WatchConfig*, uint8_t, bool*);
+static int8_t       get_next_available_watch_entry(const WatchConfig*);
+static int          fts_alphasort(const FTSENT**, const FTSENT**);
+static int          load_config(void);
+static WatchConfig* begin_watch_table_update(void);
+static void         publish_watch_table(WatchConfig*);
+static void         release_watch_slot(uint8_t);
+static int          update_watch_configs(void);
+static void         resolve_action(uint8_t);
+static void         resolve_actions(void);
 // Make our config global, because I'm terrible at C.
-DaemonConfig  daemonConfig           = { 0 };
-WatchConfig   watchConfig[WATCH_MAX] = { 0 };
-FBInkConfig   fbinkConfig            = { 0 };
-FBInkState    fbinkState             = { 0 };
-bool          need_pen_mode          = false;
+DaemonConfig        daemonConfig              = { 0 };
+// NOTE: The watch table is double-buffered: any config change (a reload, or releasing a slot) builds the next table
+//       in the spare buffer, and publishes it with a single pointer swap (c.f., publish_watch_table),
+//       so readers never see a half-updated watch. watchConfigGen is bumped on every swap.
+//       The only fields updated in place are the event loop's own per-watch bookkeeping
+//       (inotify_wd, wd_was_destroyed, pending_processing & processing_ts), which a swap simply carries over.
+//       It's all main-thread only: nothing else ever reads it.
+// NOTE: Running processes only refer to their watch by index, so a running watch is never updated,
+//       and its slot is never reused before it's reaped (c.f., WatchConfig.pending_release).
+WatchConfig         watchTables[2][WATCH_MAX] = { 0 };
+WatchConfig*        watchConfig               = watchTables[0];
+uint32_t            watchConfigGen            = 0U;
+FBInkConfig         fbinkConfig               = { 0 };
+FBInkState          fbinkState                = { 0 };
+bool                need_pen_mode             = false;
+
+// Pre-resolved actions, so that launching one doesn't involve a PATH search and a full path walk on the userstore.
+// Refreshed every time we check the watch configs for updates (i.e., on startup, and after an USBMS session).
+// NOTE: We can only hold an fd for actions *outside* of the target mountpoint,
+//       as it would otherwise prevent Nickel from unmounting it when starting an USBMS session.
+struct
+{
+	// Canonical path to the action, empty if it failed validation (in which case we just execvp whatever the config says).
+	char path[PATH_MAX];
+	// O_PATH fd to the action, only for binaries outside the target mountpoint, -1 otherwise.
+	int  fd;
+} actionCache[WATCH_MAX] = { [0 ... WATCH_MAX - 1] = { .fd = -1 } };
+
+// Cheap fb state snapshot, used to decide whether FBInk actually needs a reinit before printing something
+struct
+{
+	struct fb_var_screeninfo vinfo;
+	struct fb_fix_screeninfo finfo;
+	int                      fbfd;
+} fbSnapshot = { .fbfd = -1 };
 
 // NOTE: Unless we're able to tell FBInk to follow the wb's rotation (i.e., with fbdamage's help),
 //       we want to bracket our refreshes in "pen" mode on older sunxi kernels (c.f., FBInk/#64 for more details),
 //       so handle the switcheroo in a macro to avoid code duplication...
+// NOTE: The fb state is only refreshed right before we actually print something (c.f., refresh_fbink_state),
+//       and, since we're playing with library globals, this is main-thread only...
 #define FB_PRINT(msg)                                                                                                    \
 	({                                                                                                               \
+		refresh_fbink_state();                                                                                   \
 		if (need_pen_mode) {                                                                                     \
 			int fbfd = fbink_open();                                                                         \
 			fbink_sunxi_toggle_ntx_pen_mode(fbfd, true);                                                     \
@@ -293,6 +584,7 @@ bool          need_pen_mode          = false;
 
 #define FB_PRINTF(fmt, ...)                                                                                              \
 	({                                                                                                               \
+		refresh_fbink_state();                                                                                   \
 		if (need_pen_mode) {                                                                                     \
 			int fbfd = fbink_open();                                                                         \
 			fbink_sunxi_toggle_ntx_pen_mode(fbfd, true);                                                     \
@@ -311,22 +603,275 @@ bool          need_pen_mode          = false;
 #define BOOL2STR(X) ({ ("false\0\0\0true" + 8 * !!(X)); })
 
 static unsigned int qhash(const unsigned char* restrict, size_t);
+static bool         query_target_processed(uint8_t, bool);
 static bool         is_target_processed(uint8_t, bool);
 
-static void* reaper_thread(void*);
+// What our spawn children need to know (they share our address space until they exec).
+struct spawn_args
+{
+	char* const* command;
+	// Pre-resolved action (c.f., actionCache)
+	const char*  exec_path;
+	int          exec_fd;
+	char* const* envp;
+	// The child's end of a standby's gate, -1 otherwise.
+	int          gate_fd;
+	// Per-watch scheduling & resource controls
+	const SpawnTuning* tuning;
+	// Path to the cgroup.procs file of tuning->cgroup, empty if none.
+	const char*  cgroup_procs;
+	// Write end of the CLOEXEC pipe used to report failures (as a spawn_status).
+	int          status_fd;
+};
+// What went wrong in a spawn child, as reported over the status pipe.
+// Only a failure to exec is fatal, the others are merely reported, and the child carries on.
+typedef enum
+{
+	SPAWN_STEP_EXEC = 0,
+	SPAWN_STEP_CGROUP,
+	SPAWN_STEP_RLIMIT,
+	SPAWN_STEP_AFFINITY,
+	SPAWN_STEP_SCHED,
+	SPAWN_STEP_IOPRIO,
+	SPAWN_STEP_NICE,
+} SpawnStep;
+struct spawn_status
+{
+	int step;
+	int err;
+};
+static const char* spawn_step_names[] = { "exec", "cgroup", "rlimit", "cpu_affinity", "sched", "ioprio", "nice" };
+
+// NOTE: The glibc doesn't wrap ioprio_set, nor does it ship the constants (c.f., linux/ioprio.h).
+#ifndef IOPRIO_CLASS_SHIFT
+#	define IOPRIO_CLASS_SHIFT 13
+#endif
+#ifndef IOPRIO_PRIO_VALUE
+#	define IOPRIO_PRIO_VALUE(class, data) (((class) << IOPRIO_CLASS_SHIFT) | (data))
+#endif
+enum
+{
+	IOPRIO_CLASS_NONE,
+	IOPRIO_CLASS_RT,
+	IOPRIO_CLASS_BE,
+	IOPRIO_CLASS_IDLE,
+};
+#define IOPRIO_WHO_PROCESS 1
+// The stack our spawn children run on until they exec.
+// NOTE: execvp may need to build a PATH_MAX-sized buffer on it, so, don't go too low.
+#define SPAWN_STACK_SIZE (64U * 1024U)
+void*        spawn_stack = NULL;
+static void  report_spawn_step(int, SpawnStep, int);
+static int   spawn_child(void*);
+static pid_t launch_process(char* const*, const char*, int, int, const SpawnTuning*);
+static pid_t spawn_process(char* const*, uint8_t, int, long int*);
 static pid_t spawn(char* const*, uint8_t);
 
+#ifdef KFMON_SPAWN_HELPER
+// With SPAWN_HELPER=true, actions aren't launched by us, but by a tiny helper process we fork early on,
+// before SQLite & FBInk are setup (c.f., start_spawn_helper).
+// What we send it for each launch (argv0 only, like spawn() ever needs).
+// NOTE: The action's O_PATH fd & a standby's gate, if any, tag along as SCM_RIGHTS, in that order.
+struct spawn_request
+{
+	SpawnTuning tuning;
+	char        argv0[CFG_SZ_MAX];
+	char        exec_path[PATH_MAX];
+	bool        with_exec_fd;
+	bool        with_gate_fd;
+};
+// Its reply: the child's pid, or -1 and the errno it failed with.
+struct spawn_reply
+{
+	pid_t pid;
+	int   err;
+};
+// What it sends us, on a dedicated socket, whenever it has reaped one of its children.
+struct spawn_exit
+{
+	struct rusage ru;
+	pid_t         pid;
+	int           wstatus;
+};
+// Requests & replies go through req_fd, exit notifications through exit_fd (both SOCK_SEQPACKET).
+struct
+{
+	pid_t pid;
+	int   req_fd;
+	int   exit_fd;
+} spawnHelper = { .pid = -1, .req_fd = -1, .exit_fd = -1 };
+static void  start_spawn_helper(void);
+static void  spawn_helper_main(int, int) __attribute__((noreturn));
+static pid_t request_spawn(char* const*, uint8_t, int);
+static void  on_spawn_helper_event(ReactorSource*, uint32_t);
+#endif
+
+// Warm standby: for watches flagged as such, we launch the action ahead of time,
+// with an fd it's expected to block on until we get a trigger for it.
+// We then write "go\n" to it, and the action carries on.
+// If we close it without a word instead, the action is expected to just exit.
+// NOTE: That's always fd 3 (and advertised as such in its env), because most shells only handle single-digit redirections.
+#define KFMON_STANDBY_FDNO 3
+#define KFMON_STANDBY_ENV  "KFMON_STANDBY_FD=3"
+static int8_t get_standby_for_watch(uint8_t);
+static void   arm_standby(uint8_t);
+static void   arm_standbys(void);
+static void   disarm_standby(uint8_t);
+static void   disarm_standbys(void);
+
 static bool  is_watch_already_spawned(uint8_t);
 static bool  is_blocker_running(void);
 static bool  are_spawns_blocked(void);
 static pid_t get_spawn_pid_for_watch(uint8_t);
 
-static bool handle_events(int);
-static void get_process_name(const pid_t, char*);
-static void get_user_name(const uid_t, char*);
-static void get_group_name(const gid_t, char*);
-static void handle_connection(int);
-static bool handle_ipc(int);
+// What we ask inotify for
+#define KFMON_INOTIFY_MASK           (IN_OPEN | IN_CLOSE)
+// What we drop on the floor while quiescent: nothing else, so we still notice an USBMS session (IN_UNMOUNT & IN_IGNORED).
+#define KFMON_QUIESCENT_IGNORED_MASK (IN_OPEN | IN_CLOSE | IN_ISDIR)
+// Quiescent mode: while a spawn blocker is running, our only job is to refuse spawns,
+// so we get out of its way as much as we can (c.f., enter_quiescent_mode).
+struct
+{
+	// What the prefetch thread was running with before going quiescent
+	struct sched_param sched_param;
+	int                sched_policy;
+	int                ioprio;
+	bool               active;
+} quiescence = { 0 };
+static void enter_quiescent_mode(void);
+static void leave_quiescent_mode(void);
+static void update_quiescent_mode(void);
+
+// Small uid/gid -> name caches, so that logging an IPC connection doesn't have to go through NSS every time.
+// They're flushed whenever /etc/passwd or /etc/group change (c.f., on_id_cache_event).
+#define ID_CACHE_SIZE 8
+typedef struct
+{
+	uint32_t id;
+	// NOTE: Both user & group names are 32 bytes on Linux
+	char     name[32];
+	bool     valid;
+} IdCacheEntry;
+struct
+{
+	IdCacheEntry   users[ID_CACHE_SIZE];
+	IdCacheEntry   groups[ID_CACHE_SIZE];
+	ReactorSource* src;
+	// Our inotify instance on /etc, -1 if none (in which case the caches are disabled)
+	int            inotify_fd;
+	// Round-robin eviction
+	uint8_t        next_user;
+	uint8_t        next_group;
+} idCache = { .inotify_fd = -1 };
+static int  init_id_cache(void);
+static bool lookup_id_cache(const IdCacheEntry*, uint32_t, char*);
+static void store_id_cache(IdCacheEntry*, uint8_t*, uint32_t, const char*);
+static void flush_id_cache(IdCacheEntry*);
+static void on_id_cache_event(ReactorSource*, uint32_t);
+
+// IPC clients are served concurrently from the event loop, each of them as a tiny state machine:
+// we read a command, queue the reply, flush it whenever the socket lets us, and go back to reading.
+// Max amount of clients we serve at once (any more than that are turned away on accept)
+#define IPC_CLIENTS_MAX            16
+// Clients that stay silent (or that stop draining our replies) for that long (in ms) are dropped
+#define IPC_IDLE_TIMEOUT_MS        (60 * 1000)
+// Subscribers that let that many bytes of events pile up are dropped
+#define IPC_SUBSCRIBER_BACKLOG_MAX (64U * 1024U)
+// Max size of a single event, LF included (c.f., NOTIFY_SUBSCRIBERS)
+#define IPC_EVENT_SZ_MAX           (CFG_SZ_MAX + 64U)
+// Max amount of events a single command may fire while we're replying to it (e.g., spawned, blocked & failed)
+#define IPC_DEFERRED_EVENTS_MAX    8U
+typedef struct
+{
+	struct ucred   ucred;
+	// Replies are queued here, and sent from out + out_off whenever the socket is writable
+	char*          out;
+	size_t         out_size;
+	size_t         out_len;
+	size_t         out_off;
+	ReactorSource* src;
+	// CLOCK_MONOTONIC_RAW, in ms
+	long int       deadline;
+	int            fd;
+	// Framed requests (protocol v2) are accumulated here until they're complete
+	char           in[sizeof(KFMonIPCRequest) + KFMON_IPC_MAX_REQUEST_LEN];
+	size_t         in_len;
+	// Set on EoF: we hang up as soon as the pending replies have been flushed
+	bool           closing;
+	// Events that fired while we were in the middle of a reply, queued once it's complete (c.f., end_ipc_message)
+	char           deferred[IPC_DEFERRED_EVENTS_MAX * IPC_EVENT_SZ_MAX];
+	size_t         deferred_len;
+	// Whether we push events to it (c.f., notify_subscribers)
+	bool           subscribed;
+	// Whether we're in the middle of queuing a message (c.f., begin_ipc_message)
+	bool           in_message;
+	// Whether the names below have been looked up yet (c.f., identify_ipc_client)
+	bool           identified;
+	// SOCK_SEQPACKET connection: each message in out is prefixed by its length (which never hits the wire),
+	// so that it can be sent as a single datagram (c.f., begin_ipc_message).
+	bool           seqpacket;
+	// Protocol version in use on this connection (c.f., utils/ipc_proto.h)
+	uint8_t        protocol;
+	// NOTE: comm is 16 bytes, user & group names are 32 bytes on Linux
+	char           pname[16];
+	char           uname[32];
+	char           gname[32];
+} IpcClient;
+// NOTE: Main thread only.
+IpcClient* ipcClients[IPC_CLIENTS_MAX] = { 0 };
+// Pre-serialized replies to the list & gui-list IPC commands (final NUL included),
+// rebuilt on demand whenever the watch table changes (c.f., watchConfigGen).
+// NOTE: A line is at most id:basename(filename):label\n
+#define IPC_LIST_LINE_MAX (CFG_SZ_MAX * 2U + 8U)
+struct
+{
+	char     list[WATCH_MAX * IPC_LIST_LINE_MAX + 1U];
+	char     gui_list[WATCH_MAX * IPC_LIST_LINE_MAX + 1U];
+	size_t   list_len;
+	size_t   gui_list_len;
+	// The watchConfigGen they were built for
+	uint32_t gen;
+} ipcListCache = { .gen = UINT32_MAX };
+
+static bool     handle_events(int);
+static void     on_inotify_event(ReactorSource*, uint32_t);
+static void     on_ipc_connection(ReactorSource*, uint32_t);
+static void     on_ipc_client(ReactorSource*, uint32_t);
+static void     get_process_name(const pid_t, char*);
+static void     get_user_name(const uid_t, char*);
+static void     get_group_name(const gid_t, char*);
+static void     identify_ipc_client(IpcClient*);
+static long int get_monotonic_ms(void);
+static int      setup_ipc_socket(const char*, int);
+static void     handle_connection(int, int);
+static void     close_ipc_client(IpcClient*);
+static int      queue_ipc_reply(IpcClient*, const char*, size_t);
+static int      begin_ipc_message(IpcClient*, size_t*);
+static void     end_ipc_message(IpcClient*, size_t);
+static bool     flush_ipc_client(IpcClient*);
+static int      expire_ipc_clients(void);
+static uint16_t get_ipc_status(const char*, size_t);
+static bool     handle_ipc_frames(IpcClient*);
+static bool     handle_ipc_datagram(IpcClient*, size_t);
+static bool     handle_ipc_command(IpcClient*, const char*, size_t);
+static bool     handle_ipc(IpcClient*);
+static int      queue_ipc_event(IpcClient*, const char*, size_t);
+static void     drop_ipc_subscriber(IpcClient*);
+static void     notify_subscribers(const char*, size_t);
+static void     refresh_ipc_list_cache(void);
+
+// Push an event (a single line, c.f., the subscribe IPC command) to every subscribed IPC client.
+// NOTE: A truncated event keeps its final LF, so that it's still a single line.
+#define NOTIFY_SUBSCRIBERS(fmt, ...)                                                                                     \
+	({                                                                                                               \
+		char _event[IPC_EVENT_SZ_MAX + 1U];                                                                      \
+		int  _len = snprintf(_event, sizeof(_event), fmt "\n", ##__VA_ARGS__);                                   \
+		if (_len > 0) {                                                                                          \
+			size_t _event_len = MIN((size_t) _len, sizeof(_event) - 1U);                                     \
+			_event[_event_len - 1U] = '\n';                                                                  \
+			notify_subscribers(_event, _event_len);                                                          \
+		}                                                                                                        \
+	})
 
 static void sql_errorlogcb(void* __attribute__((unused)), int, const char*);
 
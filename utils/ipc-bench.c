@@ -0,0 +1,581 @@
+/*
+	KFMon: Kobo inotify-based launcher
+	Copyright (C) 2016-2024 NiLuJe <ninuje@gmail.com>
+	SPDX-License-Identifier: GPL-3.0-or-later
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+// Small benchmark of KFMon's IPC: it starts a sandboxed KFMon instance on a fake config tree,
+// has N concurrent clients hammer it with a mix of list, start & trigger requests,
+// and reports the throughput, as well as the latency percentiles of those requests.
+// Meanwhile, it measures the latency between an inotify event on a trigger file and the resulting spawn,
+// both on an idle daemon and under that IPC load (that's what users would actually notice).
+// NOTE: The spawn is detected via the spawned event pushed to subscribers (c.f., the subscribe IPC command),
+//       which KFMon sends right after the clone, so this doesn't account for the exec itself (c.f., spawn-bench for that).
+// NOTE: This has to be built w/ the same paths as the KFMon instance it drives (c.f., the ipc-bench target in the Makefile),
+//       and KFMON_TARGET_MOUNTPOINT has to be an actual mountpoint (e.g., a tmpfs).
+//       That KFMon build also honors skip_db_checks (like a DEBUG build would), as we don't have a Nickel DB to check.
+
+// Because we're pretty much Linux-bound ;).
+#ifndef _GNU_SOURCE
+#	define _GNU_SOURCE
+#endif
+
+#include "libkfmonipc.h"
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <mntent.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef KFMON_TARGET_MOUNTPOINT
+#	error "Build this w/ the same paths as the KFMon instance it drives (c.f., BENCH_CPPFLAGS in the Makefile)!"
+#endif
+#ifndef KFMON_PID_FILE
+#	error "Build this w/ the same paths as the KFMon instance it drives (c.f., BENCH_CPPFLAGS in the Makefile)!"
+#endif
+
+#define BENCH_CONFIGPATH KFMON_TARGET_MOUNTPOINT "/.adds/kfmon/config"
+#define BENCH_PROBE_FILE KFMON_TARGET_MOUNTPOINT "/probe.png"
+// How long we give KFMon to come up, in ms
+#define BENCH_STARTUP_MS 10000
+// Matches WATCH_MAX, minus the probe
+#define BENCH_WATCHES_MAX 15U
+
+// A load watch, as listed by KFMon
+typedef struct
+{
+	uint8_t id;
+	char    name[32];
+} BenchWatch;
+
+static BenchWatch   benchWatches[BENCH_WATCHES_MAX];
+static unsigned int benchWatchesCount = 0U;
+
+// A load client
+typedef struct
+{
+	pthread_t     thread;
+	unsigned int  idx;
+	unsigned int  requests;
+	// Every request's latency, in µs
+	uint32_t*     lat;
+	size_t        lat_len;
+	size_t        lat_size;
+	unsigned long warnings;
+	unsigned long errors;
+	// errno of the failure that stopped us early, if any
+	int           err;
+} BenchClient;
+
+// Set once the probe under load is done, load clients keep going until then
+static int probeDone = 0;
+
+static uint32_t
+    elapsed_us(const struct timespec* t0, const struct timespec* t1)
+{
+	return (uint32_t) ((t1->tv_sec - t0->tv_sec) * 1000000L + (t1->tv_nsec - t0->tv_nsec) / 1000L);
+}
+
+static bool
+    is_target_mounted(void)
+{
+	bool  is_mounted = false;
+	FILE* mtab       = setmntent("/proc/mounts", "r");
+	if (mtab) {
+		struct mntent* part;
+		while ((part = getmntent(mtab)) != NULL) {
+			if (part->mnt_dir != NULL && strcmp(part->mnt_dir, KFMON_TARGET_MOUNTPOINT) == 0) {
+				is_mounted = true;
+				break;
+			}
+		}
+		endmntent(mtab);
+	}
+
+	return is_mounted;
+}
+
+static void
+    write_file(const char* path, const char* content, mode_t mode)
+{
+	int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, mode);
+	if (fd == -1) {
+		fprintf(stderr, "[%s] Aborting: open(%s): %m!\n", __PRETTY_FUNCTION__, path);
+		exit(EXIT_FAILURE);
+	}
+	size_t len = strlen(content);
+	if (write(fd, content, len) != (ssize_t) len) {
+		fprintf(stderr, "[%s] Aborting: write(%s): %m!\n", __PRETTY_FUNCTION__, path);
+		exit(EXIT_FAILURE);
+	}
+	close(fd);
+}
+
+// Build a fake config tree: a probe watch, and a few load watches, all of them running /bin/true
+static void
+    setup_config_tree(unsigned int watches)
+{
+	const char* dirs[] = { KFMON_TARGET_MOUNTPOINT "/.adds", KFMON_TARGET_MOUNTPOINT "/.adds/kfmon", BENCH_CONFIGPATH };
+	for (size_t i = 0U; i < sizeof(dirs) / sizeof(*dirs); i++) {
+		if (mkdir(dirs[i], 0755) == -1 && errno != EEXIST) {
+			fprintf(stderr, "[%s] Aborting: mkdir(%s): %m!\n", __PRETTY_FUNCTION__, dirs[i]);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	// Start from a clean slate, in case an earlier run used more watches
+	DIR* dir = opendir(BENCH_CONFIGPATH);
+	if (dir) {
+		struct dirent* entry;
+		while ((entry = readdir(dir)) != NULL) {
+			if (strstr(entry->d_name, ".ini")) {
+				unlinkat(dirfd(dir), entry->d_name, 0);
+			}
+		}
+		closedir(dir);
+	}
+
+	write_file(BENCH_CONFIGPATH "/kfmon.ini", "[daemon]\nuse_syslog = 0\nwith_notifications = 0\n", 0644);
+
+	char path[PATH_MAX];
+	char cfg[512];
+	for (unsigned int i = 0U; i < watches; i++) {
+		snprintf(path, sizeof(path), "%s/load-%02u.png", KFMON_TARGET_MOUNTPOINT, i);
+		write_file(path, "", 0644);
+		snprintf(cfg,
+			 sizeof(cfg),
+			 "[watch]\nfilename = %s/load-%02u.png\naction = /bin/true\nlabel = Load %u\nskip_db_checks = 1\n",
+			 KFMON_TARGET_MOUNTPOINT,
+			 i,
+			 i);
+		snprintf(path, sizeof(path), "%s/load-%02u.ini", BENCH_CONFIGPATH, i);
+		write_file(path, cfg, 0644);
+	}
+	write_file(BENCH_PROBE_FILE, "", 0644);
+	write_file(BENCH_CONFIGPATH "/probe.ini",
+		   "[watch]\nfilename = " BENCH_PROBE_FILE "\naction = /bin/true\nlabel = Probe\nskip_db_checks = 1\n",
+		   0644);
+}
+
+// Kill the KFMon instance we (or an earlier run) started, if any
+static void
+    stop_kfmon(void)
+{
+	FILE* f = fopen(KFMON_PID_FILE, "re");
+	if (f == NULL) {
+		return;
+	}
+	long pid = 0L;
+	if (fscanf(f, "%ld", &pid) == 1 && pid > 1L) {
+		kill((pid_t) pid, SIGTERM);
+	}
+	fclose(f);
+	unlink(KFMON_PID_FILE);
+}
+
+// Start KFMon (it daemonizes itself), and connect to it
+static void
+    start_kfmon(const char* kfmon, KFMonIPC* ipc)
+{
+	pid_t pid = fork();
+	if (pid == -1) {
+		fprintf(stderr, "[%s] Aborting: fork: %m!\n", __PRETTY_FUNCTION__);
+		exit(EXIT_FAILURE);
+	} else if (pid == 0) {
+		execl(kfmon, kfmon, (char*) NULL);
+		fprintf(stderr, "[%s] Aborting: execl(%s): %m!\n", __PRETTY_FUNCTION__, kfmon);
+		_exit(EXIT_FAILURE);
+	}
+	int wstatus = 0;
+	waitpid(pid, &wstatus, 0);
+	if (!WIFEXITED(wstatus) || WEXITSTATUS(wstatus) != EXIT_SUCCESS) {
+		fprintf(stderr, "[%s] Aborting: %s failed to start!\n", __PRETTY_FUNCTION__, kfmon);
+		exit(EXIT_FAILURE);
+	}
+
+	for (int waited = 0; waited < BENCH_STARTUP_MS; waited += 50) {
+		if (kfmon_ipc_connect_to(ipc, KFMON_IPC_SEQPACKET_SOCKET, BENCH_STARTUP_MS) == 0) {
+			return;
+		}
+		poll(NULL, 0, 50);
+	}
+	fprintf(stderr, "[%s] Aborting: KFMon IPC never came up (connect: %m)!\n", __PRETTY_FUNCTION__);
+	stop_kfmon();
+	exit(EXIT_FAILURE);
+}
+
+// Wait for KFMon to pick up our config tree, and remember the ids of our watches.
+// Returns the probe's id.
+static uint8_t
+    list_watches(KFMonIPC* ipc, unsigned int watches)
+{
+	for (int waited = 0; waited < BENCH_STARTUP_MS; waited += 50) {
+		char     buf[4096];
+		uint16_t status;
+		if (kfmon_ipc_request(ipc, "list", &status, buf, sizeof(buf)) == -1) {
+			fprintf(stderr, "[%s] Aborting: list: %m!\n", __PRETTY_FUNCTION__);
+			stop_kfmon();
+			exit(EXIT_FAILURE);
+		}
+
+		int   probe_id  = -1;
+		char* save_ptr  = NULL;
+		benchWatchesCount = 0U;
+		for (char* line = strtok_r(buf, "\n", &save_ptr); line; line = strtok_r(NULL, "\n", &save_ptr)) {
+			uint8_t id;
+			char    name[32];
+			if (sscanf(line, "%hhu:%31[^:]", &id, name) != 2) {
+				continue;
+			}
+			if (strcmp(name, "probe.png") == 0) {
+				probe_id = id;
+			} else if (strncmp(name, "load-", 5) == 0 && benchWatchesCount < BENCH_WATCHES_MAX) {
+				benchWatches[benchWatchesCount].id = id;
+				memcpy(benchWatches[benchWatchesCount].name, name, sizeof(name));
+				benchWatchesCount++;
+			}
+		}
+		if (probe_id != -1 && benchWatchesCount == watches) {
+			return (uint8_t) probe_id;
+		}
+		poll(NULL, 0, 50);
+	}
+	fprintf(stderr, "[%s] Aborting: KFMon never picked up our watches!\n", __PRETTY_FUNCTION__);
+	stop_kfmon();
+	exit(EXIT_FAILURE);
+}
+
+// Wait for a specific event (prefix) from a subscription, ignoring the rest
+static void
+    wait_for_event(KFMonIPC* sub, const char* prefix)
+{
+	size_t prefix_len = strlen(prefix);
+	while (1) {
+		KFMonIPCReply reply;
+		char          buf[256];
+		if (kfmon_ipc_recv(sub, &reply, buf, sizeof(buf)) == -1) {
+			fprintf(stderr, "[%s] Aborting: no %s event (%m)!\n", __PRETTY_FUNCTION__, prefix);
+			stop_kfmon();
+			exit(EXIT_FAILURE);
+		}
+		if (reply.id == 0U && strncmp(buf, prefix, prefix_len) == 0) {
+			return;
+		}
+	}
+}
+
+// Returns the event -> spawn latency, in µs
+static uint32_t
+    probe_once(KFMonIPC* sub, uint8_t probe_id)
+{
+	char spawned[32];
+	char exited[32];
+	snprintf(spawned, sizeof(spawned), "spawned:%hhu:", probe_id);
+	snprintf(exited, sizeof(exited), "exited:%hhu:", probe_id);
+
+	struct timespec t0 = { 0 };
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	// Much like Nickel, just open the trigger file
+	int fd = open(BENCH_PROBE_FILE, O_RDONLY | O_CLOEXEC);
+	if (fd == -1) {
+		fprintf(stderr, "[%s] Aborting: open: %m!\n", __PRETTY_FUNCTION__);
+		stop_kfmon();
+		exit(EXIT_FAILURE);
+	}
+	close(fd);
+	wait_for_event(sub, spawned);
+	struct timespec t1 = { 0 };
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+
+	// Don't trip the already running check on the next round
+	wait_for_event(sub, exited);
+
+	return elapsed_us(&t0, &t1);
+}
+
+static void
+    probe(KFMonIPC* sub, uint8_t probe_id, uint32_t* lat, unsigned int events)
+{
+	for (unsigned int i = 0U; i < events; i++) {
+		lat[i] = probe_once(sub, probe_id);
+		// Leave KFMon some slack to re-arm the watch
+		poll(NULL, 0, 20);
+	}
+}
+
+static void*
+    client_thread(void* arg)
+{
+	BenchClient* client = arg;
+	KFMonIPC     ipc;
+	if (kfmon_ipc_connect_to(&ipc, KFMON_IPC_SEQPACKET_SOCKET, KFMON_IPC_DEFAULT_TIMEOUT_MS) == -1) {
+		client->err = errno;
+		return NULL;
+	}
+
+	for (unsigned int i = 0U; i < client->requests || !__atomic_load_n(&probeDone, __ATOMIC_ACQUIRE); i++) {
+		// Half list, a quarter start, a quarter trigger, spread over our load watches
+		const BenchWatch* watch = &benchWatches[(client->idx + i / 4U) % benchWatchesCount];
+		char              cmd[64];
+		switch ((client->idx + i) % 4U) {
+			case 2U:
+				snprintf(cmd, sizeof(cmd), "start:%hhu", watch->id);
+				break;
+			case 3U:
+				snprintf(cmd, sizeof(cmd), "trigger:%s", watch->name);
+				break;
+			default:
+				snprintf(cmd, sizeof(cmd), "list");
+				break;
+		}
+
+		if (client->lat_len == client->lat_size) {
+			size_t    size = client->lat_size ? client->lat_size * 2U : client->requests;
+			uint32_t* lat  = realloc(client->lat, size * sizeof(*lat));
+			if (lat == NULL) {
+				client->err = errno;
+				break;
+			}
+			client->lat      = lat;
+			client->lat_size = size;
+		}
+
+		char            buf[4096];
+		uint16_t        status;
+		struct timespec t0 = { 0 };
+		clock_gettime(CLOCK_MONOTONIC, &t0);
+		if (kfmon_ipc_request(&ipc, cmd, &status, buf, sizeof(buf)) == -1) {
+			client->err = errno;
+			break;
+		}
+		struct timespec t1 = { 0 };
+		clock_gettime(CLOCK_MONOTONIC, &t1);
+		client->lat[client->lat_len++] = elapsed_us(&t0, &t1);
+
+		// NOTE: WARN_ALREADY_RUNNING is par for the course here
+		if (kfmon_ipc_status_is_error(status)) {
+			client->errors++;
+		} else if (status != KFMON_IPC_OK) {
+			client->warnings++;
+		}
+	}
+
+	kfmon_ipc_close(&ipc);
+	return NULL;
+}
+
+static int
+    compare_u32(const void* a, const void* b)
+{
+	uint32_t x = *(const uint32_t*) a;
+	uint32_t y = *(const uint32_t*) b;
+	return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of a sorted array
+static uint32_t
+    percentile(const uint32_t* sorted, size_t len, unsigned int per_mille)
+{
+	size_t rank = (len * per_mille + 999U) / 1000U;
+	return sorted[rank ? rank - 1U : 0U];
+}
+
+static void
+    report(const char* name, uint32_t* lat, size_t len)
+{
+	if (len == 0U) {
+		return;
+	}
+	qsort(lat, len, sizeof(*lat), compare_u32);
+	fprintf(stdout,
+		"%-18s %zu samples: p50 %uus, p99 %uus, p999 %uus, max %uus\n",
+		name,
+		len,
+		percentile(lat, len, 500U),
+		percentile(lat, len, 990U),
+		percentile(lat, len, 999U),
+		lat[len - 1U]);
+}
+
+int
+    main(int argc, char* argv[])
+{
+	const char*  kfmon    = "./kfmon-bench";
+	unsigned int clients  = 8U;
+	unsigned int requests = 1000U;
+	unsigned int events   = 50U;
+	unsigned int watches  = 4U;
+
+	int opt;
+	while ((opt = getopt(argc, argv, "k:c:n:e:w:h")) != -1) {
+		switch (opt) {
+			case 'k':
+				kfmon = optarg;
+				break;
+			case 'c':
+				clients = (unsigned int) strtoul(optarg, NULL, 10);
+				break;
+			case 'n':
+				requests = (unsigned int) strtoul(optarg, NULL, 10);
+				break;
+			case 'e':
+				events = (unsigned int) strtoul(optarg, NULL, 10);
+				break;
+			case 'w':
+				watches = (unsigned int) strtoul(optarg, NULL, 10);
+				break;
+			case 'h':
+			default:
+				fprintf(stderr,
+					"Usage: %s [-k kfmon-bench] [-c clients] [-n requests_per_client] [-e probe_events] [-w load_watches]\n",
+					argv[0]);
+				exit(opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE);
+		}
+	}
+	if (clients == 0U) {
+		clients = 1U;
+	}
+	if (requests == 0U) {
+		requests = 1U;
+	}
+	if (events == 0U) {
+		events = 1U;
+	}
+	if (watches == 0U) {
+		watches = 1U;
+	} else if (watches > BENCH_WATCHES_MAX) {
+		watches = BENCH_WATCHES_MAX;
+	}
+
+	if (!is_target_mounted()) {
+		fprintf(stderr,
+			"%s isn't mounted, try: mount -t tmpfs tmpfs %s\n",
+			KFMON_TARGET_MOUNTPOINT,
+			KFMON_TARGET_MOUNTPOINT);
+		exit(EXIT_FAILURE);
+	}
+
+	stop_kfmon();
+	setup_config_tree(watches);
+	KFMonIPC sub;
+	start_kfmon(kfmon, &sub);
+	uint8_t probe_id = list_watches(&sub, watches);
+
+	char     buf[256];
+	uint16_t status;
+	if (kfmon_ipc_request(&sub, "subscribe", &status, buf, sizeof(buf)) == -1 || status != KFMON_IPC_OK) {
+		fprintf(stderr, "[%s] Aborting: subscribe failed!\n", __PRETTY_FUNCTION__);
+		stop_kfmon();
+		exit(EXIT_FAILURE);
+	}
+
+	uint32_t* idle_lat = calloc(events, sizeof(*idle_lat));
+	uint32_t* load_lat = calloc(events, sizeof(*load_lat));
+	BenchClient* pool  = calloc(clients, sizeof(*pool));
+	if (idle_lat == NULL || load_lat == NULL || pool == NULL) {
+		fprintf(stderr, "[%s] Aborting: calloc: %m!\n", __PRETTY_FUNCTION__);
+		stop_kfmon();
+		exit(EXIT_FAILURE);
+	}
+
+	fprintf(stdout,
+		"%u clients, %u requests each, over %u load watches, %u probe events\n",
+		clients,
+		requests,
+		watches,
+		events);
+
+	// Event -> spawn on an idle daemon, as a baseline
+	probe(&sub, probe_id, idle_lat, events);
+
+	struct timespec t0 = { 0 };
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for (unsigned int i = 0U; i < clients; i++) {
+		pool[i].idx      = i;
+		pool[i].requests = requests;
+		if (pthread_create(&pool[i].thread, NULL, client_thread, &pool[i]) != 0) {
+			fprintf(stderr, "[%s] Aborting: pthread_create failed!\n", __PRETTY_FUNCTION__);
+			stop_kfmon();
+			exit(EXIT_FAILURE);
+		}
+	}
+	// Same thing, under load
+	probe(&sub, probe_id, load_lat, events);
+	__atomic_store_n(&probeDone, 1, __ATOMIC_RELEASE);
+
+	size_t        total    = 0U;
+	unsigned long warnings = 0UL;
+	unsigned long errors   = 0UL;
+	for (unsigned int i = 0U; i < clients; i++) {
+		pthread_join(pool[i].thread, NULL);
+		if (pool[i].err) {
+			fprintf(stderr, "Client %u gave up early: %s\n", i, strerror(pool[i].err));
+		}
+		total += pool[i].lat_len;
+		warnings += pool[i].warnings;
+		errors += pool[i].errors;
+	}
+	struct timespec t1 = { 0 };
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	uint32_t elapsed_total = elapsed_us(&t0, &t1);
+	double   elapsed       = (double) elapsed_total / 1e6;
+
+	// Merge every request's latency
+	uint32_t* lat = malloc((total ? total : 1U) * sizeof(*lat));
+	if (lat == NULL) {
+		fprintf(stderr, "[%s] Aborting: malloc: %m!\n", __PRETTY_FUNCTION__);
+		stop_kfmon();
+		exit(EXIT_FAILURE);
+	}
+	size_t off = 0U;
+	for (unsigned int i = 0U; i < clients; i++) {
+		memcpy(lat + off, pool[i].lat, pool[i].lat_len * sizeof(*lat));
+		off += pool[i].lat_len;
+		free(pool[i].lat);
+	}
+
+	fprintf(stdout,
+		"%zu requests in %.3fs: %.0f req/s (%lu warnings, %lu errors)\n",
+		total,
+		elapsed,
+		(double) total / elapsed,
+		warnings,
+		errors);
+	report("request", lat, total);
+	report("event->spawn idle", idle_lat, events);
+	report("event->spawn load", load_lat, events);
+
+	kfmon_ipc_close(&sub);
+	stop_kfmon();
+
+	free(lat);
+	free(pool);
+	free(load_lat);
+	free(idle_lat);
+
+	return EXIT_SUCCESS;
+}
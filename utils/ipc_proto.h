@@ -0,0 +1,104 @@
+/*
+	KFMon: Kobo inotify-based launcher
+	Copyright (C) 2016-2024 NiLuJe <ninuje@gmail.com>
+	SPDX-License-Identifier: GPL-3.0-or-later
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// Wire format of version 2 of KFMon's IPC protocol, shared by the daemon and its clients.
+
+#ifndef __KFMON_IPC_PROTO_H
+#define __KFMON_IPC_PROTO_H
+
+#include <stdint.h>
+
+// Path to KFMon's IPC Unix sockets (overridable at compile-time, like KFMON_TARGET_MOUNTPOINT)
+#ifndef KFMON_IPC_SOCKET
+#	define KFMON_IPC_SOCKET "/tmp/kfmon-ipc.ctl"
+#endif
+// Same, but SOCK_SEQPACKET (one command per datagram, one reply per datagram)
+#ifndef KFMON_IPC_SEQPACKET_SOCKET
+#	define KFMON_IPC_SEQPACKET_SOCKET "/tmp/kfmon-ipc-seqpacket.ctl"
+#endif
+
+// Every connection starts in the legacy text protocol (version 1):
+// one command per write, answered by a NUL-terminated reply, with no way to tell where a message ends.
+// Sending "protocol:2" (optionally terminated by a LF or a NUL) switches the connection to version 2,
+// right after the "OK\n" (+ NUL) reply to that very command.
+// From then on, messages are framed:
+//   * a request is a KFMonIPCRequest header, followed by len bytes of command, using the v1 syntax (e.g., "start:2").
+//   * a reply is a KFMonIPCReply header, followed by len bytes of payload: the v1 reply, minus its final NUL.
+// Requests may be pipelined, they're answered in order, and each reply carries the id of the request it answers.
+// Events pushed to subscribers (c.f., the subscribe command) are replies with an id of 0, so requests shouldn't use it.
+// On the SOCK_SEQPACKET socket, each command (or request frame) must be sent as a single datagram,
+// and each reply (or event) is received as a single datagram.
+// A request datagram that doesn't hold exactly one whole frame is answered with an ERR_MALFORMED_CMD reply
+// (one too short to even hold a header gets the connection dropped).
+// NOTE: Headers are in host byte order, as this only ever goes through a Unix socket.
+//       On the stream socket, frames may be sent right behind the "protocol:2" command, without waiting for its reply,
+//       in which case its terminator (LF or NUL) is mandatory: without it, the command is rejected as malformed.
+#define KFMON_IPC_PROTOCOL_VERSION 2
+// Max size of a request's command (the daemon drops clients that send anything larger)
+#define KFMON_IPC_MAX_REQUEST_LEN  4095U
+
+typedef struct
+{
+	uint32_t len;
+	uint32_t id;
+} KFMonIPCRequest;
+
+typedef struct
+{
+	uint32_t len;
+	uint32_t id;
+	// A KFMonIPCStatus
+	uint16_t status;
+	uint16_t reserved;
+} KFMonIPCReply;
+
+// The status keyword a v1 reply starts with, if any (replies without one, e.g., to list or version, are KFMON_IPC_OK).
+// NOTE: Warnings always sort before errors, so status >= KFMON_IPC_ERR_INVALID_ID means the request failed.
+typedef enum
+{
+	KFMON_IPC_OK = 0,
+	KFMON_IPC_WARN_ALREADY_RUNNING,
+	KFMON_IPC_WARN_SPAWN_BLOCKED,
+	KFMON_IPC_WARN_SPAWN_INHIBITED,
+	KFMON_IPC_WARN_NO_PREFETCH,
+	KFMON_IPC_ERR_INVALID_ID,
+	KFMON_IPC_ERR_MALFORMED_CMD,
+	KFMON_IPC_ERR_REALLY_MALFORMED_CMD,
+	KFMON_IPC_ERR_SPAWN_FAILED,
+	KFMON_IPC_ERR_INVALID_CMD,
+	KFMON_IPC_ERR_UNSUPPORTED_PROTOCOL,
+	KFMON_IPC_STATUS_COUNT
+} KFMonIPCStatus;
+
+// Indexed by KFMonIPCStatus, these are the keywords used on the wire
+static const char* const kfmon_ipc_status_names[KFMON_IPC_STATUS_COUNT] __attribute__((unused)) = {
+	"OK",
+	"WARN_ALREADY_RUNNING",
+	"WARN_SPAWN_BLOCKED",
+	"WARN_SPAWN_INHIBITED",
+	"WARN_NO_PREFETCH",
+	"ERR_INVALID_ID",
+	"ERR_MALFORMED_CMD",
+	"ERR_REALLY_MALFORMED_CMD",
+	"ERR_SPAWN_FAILED",
+	"ERR_INVALID_CMD",
+	"ERR_UNSUPPORTED_PROTOCOL",
+};
+
+#endif
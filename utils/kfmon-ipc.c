@@ -20,6 +20,8 @@
 // Small client that sends stdin to the KFMon IPC socket and prints the replies.
 // Replies are always sent to stdout, stderr is used for errors and 'UI'
 // (i.e., in a script, you'll generally want to discard stderr).
+// When commands are passed as arguments instead, they're all sent over a single connection (c.f., run_commands),
+// and the exit code reflects the replies, making it a better fit for scripts.
 
 // Because we're pretty much Linux-bound ;).
 #ifndef _GNU_SOURCE
@@ -28,19 +30,19 @@
 
 #include "../openssh/atomicio.h"
 #include "../str5/str5.h"
+#include "libkfmonipc.h"
 #include <errno.h>
 #include <linux/limits.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <sys/un.h>
+#include <sysexits.h>
 #include <unistd.h>
 
-// Path to KFMon's IPC Unix socket
-#define KFMON_IPC_SOCKET "/tmp/kfmon-ipc.ctl"
-
 // Drain stdin and send it to the IPC socket (caller aborts on false)
 static bool
     handle_stdin(int data_fd)
@@ -139,6 +141,69 @@ static bool
 	return true;
 }
 
+// One-shot mode: send every command over a single connection, and print the replies.
+// Returns the worst status KFMon replied with (i.e., 0 if everything's OK, 1-4 for WARN_*, 5+ for ERR_*,
+// c.f., KFMonIPCStatus in utils/ipc_proto.h), or a sysexits.h code if we couldn't talk to KFMon.
+static int
+    run_commands(int count, char* cmds[])
+{
+	KFMonIPC ipc;
+	if (kfmon_ipc_connect(&ipc, KFMON_IPC_DEFAULT_TIMEOUT_MS) == -1) {
+		fprintf(stderr, "KFMon IPC is down (connect: %m), aborting!\n");
+		return EX_UNAVAILABLE;
+	}
+
+	int rc = KFMON_IPC_OK;
+
+	// Pipeline the whole batch, replies come back in order
+	for (int i = 0; i < count; i++) {
+		if (kfmon_ipc_send(&ipc, cmds[i], NULL) == -1) {
+			fprintf(stderr, "Failed to send `%s` (%m), aborting!\n", cmds[i]);
+			rc = EX_IOERR;
+			goto cleanup;
+		}
+	}
+
+	// NOTE: Large enough for a list reply w/ a full watch table
+	static char buf[65536];
+	for (int i = 0; i < count;) {
+		KFMonIPCReply reply;
+		ssize_t       len = kfmon_ipc_recv(&ipc, &reply, buf, sizeof(buf));
+		if (len == -1) {
+			if (errno == EPROTO) {
+				fprintf(stderr, "KFMon doesn't speak IPC protocol v%d, aborting!\n", KFMON_IPC_PROTOCOL_VERSION);
+				rc = EX_PROTOCOL;
+			} else if (errno == EPIPE) {
+				fprintf(stderr, "KFMon closed the connection!\n");
+				rc = EX_UNAVAILABLE;
+			} else {
+				fprintf(stderr, "No reply to `%s` (%m), aborting!\n", cmds[i]);
+				rc = EX_IOERR;
+			}
+			goto cleanup;
+		}
+		// Skip events, in case one of the commands was a subscribe
+		if (reply.id == 0U) {
+			continue;
+		}
+
+		fprintf(stderr, "<<< %s: %s\n", cmds[i], kfmon_ipc_status_name(reply.status));
+		fprintf(stdout, "%s", buf);
+		if ((size_t) len >= sizeof(buf)) {
+			fprintf(stderr, "(Reply truncated to %zu bytes out of %zd)\n", sizeof(buf) - 1U, len);
+		}
+		if (reply.status > rc) {
+			rc = reply.status;
+		}
+		i++;
+	}
+
+cleanup:
+	kfmon_ipc_close(&ipc);
+
+	return rc;
+}
+
 // Main entry point
 // NOTE: While I'd ideally want to be able to detect early if KFMon is already busy handling another IPC connection,
 //       the socket's listen backlog is inflated by the kernel, so connect() won't fail w/ EAGAIN any time soon.
@@ -148,8 +213,23 @@ static bool
 //       c.f., utils/sock_utils.h for more details about that conundrum.
 // NOTE: This means, that, yes, KFMon replying to a command is a mandatory part of the "protocol" ;).
 int
-    main(void)
+    main(int argc, char* argv[])
 {
+	if (argc > 1) {
+		if (strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--help") == 0) {
+			fprintf(stderr, "Usage: %s [command...]\n", argv[0]);
+			fprintf(stderr, "Without commands, forward stdin to KFMon's IPC interactively.\n");
+			fprintf(stderr,
+				"Otherwise, send them all over a single connection, and exit with the worst status (0: OK, %d-%d: WARN_*, %d-%d: ERR_*).\n",
+				KFMON_IPC_WARN_ALREADY_RUNNING,
+				KFMON_IPC_ERR_INVALID_ID - 1,
+				KFMON_IPC_ERR_INVALID_ID,
+				KFMON_IPC_STATUS_COUNT - 1);
+			return EX_USAGE;
+		}
+		return run_commands(argc - 1, argv + 1);
+	}
+
 	// Setup the local socket
 	int data_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
 	if (data_fd == -1) {
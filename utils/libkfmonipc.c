@@ -0,0 +1,372 @@
+/*
+	KFMon: Kobo inotify-based launcher
+	Copyright (C) 2016-2024 NiLuJe <ninuje@gmail.com>
+	SPDX-License-Identifier: GPL-3.0-or-later
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+// libkfmonipc: a tiny client library for KFMon's IPC
+
+// Because we're pretty much Linux-bound ;).
+#ifndef _GNU_SOURCE
+#	define _GNU_SOURCE
+#endif
+
+#include "libkfmonipc.h"
+#include "../str5/str5.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// How often we retry a connection while KFMon's listen backlog is full, in ms
+#define KFMON_IPC_CONNECT_RETRY_MS 10
+// How many times we try to read the state page while KFMon is updating it
+#define KFMON_STATE_SNAPSHOT_TRIES 64
+
+// Wait for events on our socket, honoring the timeout (sets errno to ETIMEDOUT on timeout)
+static int
+    wait_for_socket(const KFMonIPC* ipc, short events)
+{
+	struct pollfd pfd = { 0 };
+	pfd.fd            = ipc->fd;
+	pfd.events        = events;
+
+	while (1) {
+		int poll_num = poll(&pfd, 1, ipc->timeout_ms);
+		if (poll_num == -1) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return -1;
+		}
+		if (poll_num == 0) {
+			errno = ETIMEDOUT;
+			return -1;
+		}
+		// NOTE: We let the actual send/recv call report errors & hang ups
+		return 0;
+	}
+}
+
+// Send a single datagram
+static int
+    send_datagram(const KFMonIPC* ipc, const void* buf, size_t len)
+{
+	while (1) {
+		if (send(ipc->fd, buf, len, MSG_NOSIGNAL) != -1) {
+			return 0;
+		}
+		if (errno == EINTR) {
+			continue;
+		}
+		if (errno != EAGAIN) {
+			return -1;
+		}
+		if (wait_for_socket(ipc, POLLOUT) == -1) {
+			return -1;
+		}
+	}
+}
+
+// Receive a single datagram, scattered over iov (returns its full size, even if it was truncated)
+static ssize_t
+    recv_datagram(const KFMonIPC* ipc, struct iovec* iov, size_t iovlen)
+{
+	struct msghdr msg = { 0 };
+	msg.msg_iov       = iov;
+	msg.msg_iovlen    = iovlen;
+
+	while (1) {
+		// NOTE: MSG_TRUNC makes recvmsg return the real size of the datagram
+		ssize_t len = recvmsg(ipc->fd, &msg, MSG_TRUNC);
+		if (len > 0) {
+			return len;
+		}
+		if (len == 0) {
+			// EoF
+			errno = EPIPE;
+			return -1;
+		}
+		if (errno == EINTR) {
+			continue;
+		}
+		if (errno != EAGAIN) {
+			return -1;
+		}
+		if (wait_for_socket(ipc, POLLIN) == -1) {
+			return -1;
+		}
+	}
+}
+
+// Check the (v1) reply to our protocol switch
+static int
+    finish_handshake(KFMonIPC* ipc)
+{
+	char         buf[64] = { 0 };
+	struct iovec iov     = { .iov_base = buf, .iov_len = sizeof(buf) - 1U };
+	if (recv_datagram(ipc, &iov, 1U) == -1) {
+		return -1;
+	}
+	ipc->handshake_pending = false;
+
+	if (strncmp(buf, "OK", 2) != 0) {
+		// i.e., ERR_UNSUPPORTED_PROTOCOL, or a KFMon that doesn't know about protocol:N at all
+		errno = EPROTO;
+		return -1;
+	}
+
+	return 0;
+}
+
+int
+    kfmon_ipc_connect(KFMonIPC* ipc, int timeout_ms)
+{
+	return kfmon_ipc_connect_to(ipc, KFMON_IPC_SEQPACKET_SOCKET, timeout_ms);
+}
+
+int
+    kfmon_ipc_connect_to(KFMonIPC* ipc, const char* path, int timeout_ms)
+{
+	ipc->fd                = -1;
+	ipc->timeout_ms        = timeout_ms;
+	ipc->last_id           = 0U;
+	ipc->handshake_pending = false;
+
+	int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (fd == -1) {
+		return -1;
+	}
+
+	struct sockaddr_un sock_name = { 0 };
+	sock_name.sun_family         = AF_UNIX;
+	strtcpy(sock_name.sun_path, sizeof(sock_name.sun_path), path);
+
+	// NOTE: A non-blocking connect on a Unix socket doesn't wait for the remote to accept it,
+	//       it only fails w/ EAGAIN when the listen backlog is full, in which case we retry until we time out.
+	int waited = 0;
+	while (connect(fd, (const struct sockaddr*) &sock_name, sizeof(sock_name)) == -1 && errno != EISCONN) {
+		if (errno == EINTR) {
+			continue;
+		}
+		if (errno != EAGAIN) {
+			goto fail;
+		}
+		if (timeout_ms >= 0 && waited >= timeout_ms) {
+			errno = ETIMEDOUT;
+			goto fail;
+		}
+		poll(NULL, 0, KFMON_IPC_CONNECT_RETRY_MS);
+		waited += KFMON_IPC_CONNECT_RETRY_MS;
+	}
+	ipc->fd = fd;
+
+	// Switch to the framed protocol, we'll check the reply later
+	if (send_datagram(ipc, "protocol:2", sizeof("protocol:2")) == -1) {
+		goto fail;
+	}
+	ipc->handshake_pending = true;
+
+	return 0;
+
+fail:
+	{
+		int err = errno;
+		close(fd);
+		ipc->fd = -1;
+		errno   = err;
+	}
+	return -1;
+}
+
+void
+    kfmon_ipc_close(KFMonIPC* ipc)
+{
+	if (ipc->fd != -1) {
+		close(ipc->fd);
+		ipc->fd = -1;
+	}
+}
+
+int
+    kfmon_ipc_send(KFMonIPC* ipc, const char* cmd, uint32_t* id)
+{
+	size_t cmd_len = strlen(cmd);
+	if (cmd_len > 0U && cmd[cmd_len - 1U] == '\n') {
+		cmd_len--;
+	}
+	if (cmd_len > KFMON_IPC_MAX_REQUEST_LEN) {
+		errno = EMSGSIZE;
+		return -1;
+	}
+
+	// Ids are never 0, that's reserved for events
+	ipc->last_id++;
+	if (ipc->last_id == 0U) {
+		ipc->last_id++;
+	}
+
+	// NOTE: A frame has to go in a single datagram
+	unsigned char   frame[sizeof(KFMonIPCRequest) + KFMON_IPC_MAX_REQUEST_LEN];
+	KFMonIPCRequest hdr = { .len = (uint32_t) cmd_len, .id = ipc->last_id };
+	memcpy(frame, &hdr, sizeof(hdr));
+	memcpy(frame + sizeof(hdr), cmd, cmd_len);
+	if (send_datagram(ipc, frame, sizeof(hdr) + cmd_len) == -1) {
+		return -1;
+	}
+
+	if (id) {
+		*id = hdr.id;
+	}
+	return 0;
+}
+
+ssize_t
+    kfmon_ipc_recv(KFMonIPC* ipc, KFMonIPCReply* reply, char* buf, size_t size)
+{
+	// We need room for the NUL, at the very least
+	if (size == 0U) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (ipc->handshake_pending && finish_handshake(ipc) == -1) {
+		return -1;
+	}
+
+	struct iovec iov[2] = {
+		{ .iov_base = reply, .iov_len = sizeof(*reply) },
+		{ .iov_base = buf, .iov_len = size - 1U },
+	};
+	ssize_t len = recv_datagram(ipc, iov, 2U);
+	if (len == -1) {
+		return -1;
+	}
+	if ((size_t) len < sizeof(*reply) || (size_t) len - sizeof(*reply) != reply->len) {
+		errno = EPROTO;
+		return -1;
+	}
+
+	buf[reply->len < size ? reply->len : size - 1U] = '\0';
+	return (ssize_t) reply->len;
+}
+
+ssize_t
+    kfmon_ipc_request(KFMonIPC* ipc, const char* cmd, uint16_t* status, char* buf, size_t size)
+{
+	// Don't send anything we won't be able to receive the reply to (c.f., kfmon_ipc_recv)
+	if (size == 0U) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	uint32_t id;
+	if (kfmon_ipc_send(ipc, cmd, &id) == -1) {
+		return -1;
+	}
+
+	while (1) {
+		KFMonIPCReply reply;
+		ssize_t       len = kfmon_ipc_recv(ipc, &reply, buf, size);
+		if (len == -1) {
+			return -1;
+		}
+		// Skip events, and replies to earlier requests the caller didn't wait for
+		if (reply.id == id) {
+			*status = reply.status;
+			return len;
+		}
+	}
+}
+
+const char*
+    kfmon_ipc_status_name(uint16_t status)
+{
+	if (status >= KFMON_IPC_STATUS_COUNT) {
+		return "UNKNOWN";
+	}
+	return kfmon_ipc_status_names[status];
+}
+
+bool
+    kfmon_ipc_status_is_error(uint16_t status)
+{
+	return status >= KFMON_IPC_ERR_INVALID_ID;
+}
+
+const KFMonStatePage*
+    kfmon_state_map(void)
+{
+	int fd = open(KFMON_STATE_PAGE, O_RDONLY | O_CLOEXEC);
+	if (fd == -1) {
+		return NULL;
+	}
+	void* page = mmap(NULL, sizeof(KFMonStatePage), PROT_READ, MAP_SHARED, fd, 0);
+	{
+		int err = errno;
+		close(fd);
+		errno = err;
+	}
+	if (page == MAP_FAILED) {
+		return NULL;
+	}
+
+	// NOTE: The header is only ever written once, before the first publish
+	const KFMonStatePage* state = page;
+	if (state->magic != KFMON_STATE_PAGE_MAGIC || state->version != KFMON_STATE_PAGE_VERSION ||
+	    state->size != sizeof(KFMonStatePage)) {
+		munmap(page, sizeof(KFMonStatePage));
+		errno = EPROTO;
+		return NULL;
+	}
+
+	return state;
+}
+
+void
+    kfmon_state_unmap(const KFMonStatePage* page)
+{
+	// Casting away the const is fine, we're done with it
+	munmap((void*) (uintptr_t) page, sizeof(KFMonStatePage));
+}
+
+// Seqlock reader side (c.f., publish_state_page in kfmon.c)
+int
+    kfmon_state_snapshot(const KFMonStatePage* page, KFMonStatePage* snapshot)
+{
+	for (int i = 0; i < KFMON_STATE_SNAPSHOT_TRIES; i++) {
+		uint32_t seq = __atomic_load_n(&page->seq, __ATOMIC_ACQUIRE);
+		if (seq & 1U) {
+			// KFMon is busy updating it, let it finish
+			sched_yield();
+			continue;
+		}
+		memcpy(snapshot, page, sizeof(*snapshot));
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&page->seq, __ATOMIC_RELAXED) == seq) {
+			return 0;
+		}
+	}
+
+	errno = EAGAIN;
+	return -1;
+}
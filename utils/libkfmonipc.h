@@ -0,0 +1,79 @@
+/*
+	KFMon: Kobo inotify-based launcher
+	Copyright (C) 2016-2024 NiLuJe <ninuje@gmail.com>
+	SPDX-License-Identifier: GPL-3.0-or-later
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+// libkfmonipc: a tiny client library for KFMon's IPC, over its SOCK_SEQPACKET socket, using protocol version 2.
+// c.f., utils/ipc_proto.h for the wire format.
+// Every call returns -1 and sets errno on failure, notably:
+//   ETIMEDOUT if KFMon didn't answer in time,
+//   EPIPE if KFMon closed the connection,
+//   EPROTO if KFMon didn't make sense (or is too old to speak protocol v2).
+
+#ifndef __KFMON_LIBKFMONIPC_H
+#define __KFMON_LIBKFMONIPC_H
+
+#include "ipc_proto.h"
+#include "state_page.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+// Default timeout, in ms
+#define KFMON_IPC_DEFAULT_TIMEOUT_MS 5000
+
+typedef struct
+{
+	int      fd;
+	// How long we wait for KFMon in each call, in ms (-1 to wait forever)
+	int      timeout_ms;
+	// Id of the last request we sent
+	uint32_t last_id;
+	// Whether the reply to our protocol switch is still in flight
+	bool     handshake_pending;
+} KFMonIPC;
+
+// Connect to KFMon, and switch the connection to protocol v2.
+// NOTE: The protocol switch is pipelined, its reply is checked on the first kfmon_ipc_recv.
+int         kfmon_ipc_connect(KFMonIPC* ipc, int timeout_ms);
+// Same, but to a SOCK_SEQPACKET socket at a custom path (e.g., a sandboxed KFMon instance)
+int         kfmon_ipc_connect_to(KFMonIPC* ipc, const char* path, int timeout_ms);
+void        kfmon_ipc_close(KFMonIPC* ipc);
+// Send a single command (e.g., "start:2"), its request id is stored in id (if not NULL).
+int         kfmon_ipc_send(KFMonIPC* ipc, const char* cmd, uint32_t* id);
+// Receive the next reply (or event, which have an id of 0).
+// The payload is NUL-terminated in buf, and truncated to size - 1 bytes if need be.
+// Returns the full length of the payload (i.e., it was truncated if that's >= size), or -1 on failure.
+// NOTE: size must be at least 1 (for the NUL), fails with EINVAL otherwise.
+ssize_t     kfmon_ipc_recv(KFMonIPC* ipc, KFMonIPCReply* reply, char* buf, size_t size);
+// Send a command and wait for its reply (skipping any event in the meantime), like kfmon_ipc_recv.
+ssize_t     kfmon_ipc_request(KFMonIPC* ipc, const char* cmd, uint16_t* status, char* buf, size_t size);
+// Status keyword for a KFMonIPCStatus
+const char* kfmon_ipc_status_name(uint16_t status);
+// Warnings are still successful requests
+bool        kfmon_ipc_status_is_error(uint16_t status);
+
+// Map KFMon's state page (c.f., utils/state_page.h), read-only. Returns NULL on failure.
+const KFMonStatePage* kfmon_state_map(void);
+void                  kfmon_state_unmap(const KFMonStatePage* page);
+// Take a consistent copy of the state page, without any syscall in the fast path.
+// Fails w/ EAGAIN if KFMon kept updating it for too long (just retry later).
+int                   kfmon_state_snapshot(const KFMonStatePage* page, KFMonStatePage* snapshot);
+
+#endif
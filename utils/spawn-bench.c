@@ -0,0 +1,420 @@
+/*
+	KFMon: Kobo inotify-based launcher
+	Copyright (C) 2016-2024 NiLuJe <ninuje@gmail.com>
+	SPDX-License-Identifier: GPL-3.0-or-later
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// Small benchmark comparing the latency between the spawn decision and the child's exec,
+// for a plain fork() + execvp(), posix_spawnp(), the CLONE_VM | CLONE_VFORK codepath used by KFMon,
+// and a "zygote" (i.e., a tiny helper forked early on, that does the fork + execvp on our behalf over a socketpair).
+// We dirty a chunk of memory beforehand, to roughly mimic the footprint of the daemon (SQLite, FBInk & co),
+// and we report the RSS & page tables size of both ourselves and the zygote.
+// NOTE: The exec is detected via a CLOEXEC pipe: our read() end hits EOF as soon as the child execs.
+
+// Because we're pretty much Linux-bound ;).
+#ifndef _GNU_SOURCE
+#	define _GNU_SOURCE
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+typedef pid_t (*spawn_fn)(char* const*, int);
+typedef void (*wait_fn)(pid_t);
+
+static pid_t
+    spawn_fork(char* const* command, int status_fd __attribute__((unused)))
+{
+	pid_t pid = fork();
+	if (pid == 0) {
+		// Mirror the child setup KFMon used to do by hand
+		struct sigaction sa = { .sa_handler = SIG_DFL, .sa_flags = SA_RESTART };
+		sigaction(SIGHUP, &sa, NULL);
+		sigset_t mask;
+		sigemptyset(&mask);
+		sigprocmask(SIG_SETMASK, &mask, NULL);
+		execvp(*command, command);
+		_exit(127);
+	}
+
+	return pid;
+}
+
+static pid_t
+    spawn_posix(char* const* command, int status_fd __attribute__((unused)))
+{
+	posix_spawnattr_t attr;
+	posix_spawnattr_init(&attr);
+	sigset_t sigdef;
+	sigemptyset(&sigdef);
+	sigaddset(&sigdef, SIGHUP);
+	posix_spawnattr_setsigdefault(&attr, &sigdef);
+	sigset_t mask;
+	sigemptyset(&mask);
+	posix_spawnattr_setsigmask(&attr, &mask);
+	posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_USEVFORK);
+
+	pid_t pid;
+	int   rc = posix_spawnp(&pid, *command, NULL, &attr, command, environ);
+	posix_spawnattr_destroy(&attr);
+	if (rc != 0) {
+		errno = rc;
+		return -1;
+	}
+
+	return pid;
+}
+
+static int
+    clone_child(void* arg)
+{
+	char* const* command = arg;
+
+	struct sigaction sa = { .sa_handler = SIG_DFL, .sa_flags = SA_RESTART };
+	sigaction(SIGHUP, &sa, NULL);
+	sigset_t mask;
+	sigemptyset(&mask);
+	sigprocmask(SIG_SETMASK, &mask, NULL);
+	execvp(*command, command);
+	_exit(127);
+}
+
+#define CLONE_STACK_SIZE (64U * 1024U)
+static void* clone_stack = NULL;
+
+static pid_t
+    spawn_clone(char* const* command, int status_fd __attribute__((unused)))
+{
+	if (clone_stack == NULL) {
+		void* stack = mmap(NULL,
+				   CLONE_STACK_SIZE,
+				   PROT_READ | PROT_WRITE,
+				   MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK,
+				   -1,
+				   0);
+		if (stack == MAP_FAILED) {
+			return -1;
+		}
+		clone_stack = stack;
+	}
+
+	// NOTE: Mirrors KFMon's spawn(), minus the status pipe (which is what we use to time the exec here).
+	//       Casting away the const is fine, the child doesn't touch argv.
+	return clone(clone_child,
+		     (uint8_t*) clone_stack + CLONE_STACK_SIZE,
+		     CLONE_VM | CLONE_VFORK | SIGCHLD,
+		     (void*) (uintptr_t) command);
+}
+
+static void
+    wait_child(pid_t pid)
+{
+	int wstatus;
+	waitpid(pid, &wstatus, 0);
+}
+
+// Our end of the zygote's socketpair
+static int zygote_fd = -1;
+
+// The zygote's main loop: each request carries the write end of the caller's status pipe,
+// we reply with the child's pid, and then its wait status.
+static void
+    zygote_loop(int sock, char* const* command)
+{
+	while (1) {
+		char          c;
+		struct iovec  iov = { .iov_base = &c, .iov_len = sizeof(c) };
+		union
+		{
+			char           buf[CMSG_SPACE(sizeof(int))];
+			struct cmsghdr align;
+		} cmsgbuf;
+		struct msghdr msg = {
+			.msg_iov = &iov, .msg_iovlen = 1, .msg_control = cmsgbuf.buf, .msg_controllen = sizeof(cmsgbuf)
+		};
+		if (recvmsg(sock, &msg, MSG_CMSG_CLOEXEC) <= 0) {
+			_exit(EXIT_SUCCESS);
+		}
+		struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+		if (cmsg == NULL || cmsg->cmsg_type != SCM_RIGHTS) {
+			_exit(EXIT_FAILURE);
+		}
+		int status_fd;
+		memcpy(&status_fd, CMSG_DATA(cmsg), sizeof(status_fd));
+
+		pid_t pid = spawn_fork(command, status_fd);
+		close(status_fd);
+		if (send(sock, &pid, sizeof(pid), 0) != sizeof(pid)) {
+			_exit(EXIT_FAILURE);
+		}
+		int wstatus = 0;
+		waitpid(pid, &wstatus, 0);
+		if (send(sock, &wstatus, sizeof(wstatus), 0) != sizeof(wstatus)) {
+			_exit(EXIT_FAILURE);
+		}
+	}
+}
+
+// Fork the zygote (this has to happen *before* we grow our address space)
+static pid_t
+    start_zygote(char* const* command)
+{
+	int sv[2];
+	if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sv) == -1) {
+		fprintf(stderr, "[%s] Aborting: socketpair: %m!\n", __PRETTY_FUNCTION__);
+		exit(EXIT_FAILURE);
+	}
+
+	pid_t pid = fork();
+	if (pid == -1) {
+		fprintf(stderr, "[%s] Aborting: fork: %m!\n", __PRETTY_FUNCTION__);
+		exit(EXIT_FAILURE);
+	} else if (pid == 0) {
+		close(sv[0]);
+		zygote_loop(sv[1], command);
+	}
+	close(sv[1]);
+	zygote_fd = sv[0];
+
+	return pid;
+}
+
+static pid_t
+    spawn_zygote(char* const* command __attribute__((unused)), int status_fd)
+{
+	char         c   = 'S';
+	struct iovec iov = { .iov_base = &c, .iov_len = sizeof(c) };
+	union
+	{
+		char           buf[CMSG_SPACE(sizeof(int))];
+		struct cmsghdr align;
+	} cmsgbuf;
+	memset(&cmsgbuf, 0, sizeof(cmsgbuf));
+	struct msghdr msg = {
+		.msg_iov = &iov, .msg_iovlen = 1, .msg_control = cmsgbuf.buf, .msg_controllen = sizeof(cmsgbuf.buf)
+	};
+	struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+	cmsg->cmsg_level     = SOL_SOCKET;
+	cmsg->cmsg_type      = SCM_RIGHTS;
+	cmsg->cmsg_len       = CMSG_LEN(sizeof(int));
+	memcpy(CMSG_DATA(cmsg), &status_fd, sizeof(status_fd));
+	if (sendmsg(zygote_fd, &msg, 0) == -1) {
+		return -1;
+	}
+
+	pid_t pid;
+	if (recv(zygote_fd, &pid, sizeof(pid), 0) != sizeof(pid)) {
+		return -1;
+	}
+
+	return pid;
+}
+
+static void
+    wait_zygote(pid_t pid __attribute__((unused)))
+{
+	int wstatus;
+	if (recv(zygote_fd, &wstatus, sizeof(wstatus), 0) != sizeof(wstatus)) {
+		fprintf(stderr, "[%s] Aborting: recv: %m!\n", __PRETTY_FUNCTION__);
+		exit(EXIT_FAILURE);
+	}
+}
+
+// Print the RSS & page tables size of a given process
+static void
+    print_mem(const char* who, pid_t pid)
+{
+	char path[64];
+	snprintf(path, sizeof(path), "/proc/%ld/status", (long) pid);
+	FILE* f = fopen(path, "re");
+	if (f == NULL) {
+		return;
+	}
+
+	char line[128];
+	char rss[64] = "?";
+	char pte[64] = "?";
+	while (fgets(line, sizeof(line), f)) {
+		if (sscanf(line, "VmRSS: %63[^\n]", rss) == 1) {
+			continue;
+		}
+		sscanf(line, "VmPTE: %63[^\n]", pte);
+	}
+	fclose(f);
+
+	fprintf(stdout, "%-12s VmRSS: %s, VmPTE: %s\n", who, rss, pte);
+}
+
+// Returns our own VmRSS, in kB (-1 if unknown)
+static long
+    get_rss_kb(void)
+{
+	FILE* f = fopen("/proc/self/status", "re");
+	if (f == NULL) {
+		return -1L;
+	}
+
+	char line[128];
+	long rss = -1L;
+	while (fgets(line, sizeof(line), f)) {
+		if (sscanf(line, "VmRSS: %ld", &rss) == 1) {
+			break;
+		}
+	}
+	fclose(f);
+
+	return rss;
+}
+
+// Returns the spawn -> exec latency, in µs
+static long
+    bench_once(spawn_fn fn, wait_fn wait, char* const* command)
+{
+	int pfd[2];
+	if (pipe2(pfd, O_CLOEXEC) == -1) {
+		fprintf(stderr, "[%s] Aborting: pipe2: %m!\n", __PRETTY_FUNCTION__);
+		exit(EXIT_FAILURE);
+	}
+
+	struct timespec t0 = { 0 };
+	clock_gettime(CLOCK_MONOTONIC_RAW, &t0);
+	pid_t pid = fn(command, pfd[1]);
+	if (pid == -1) {
+		fprintf(stderr, "[%s] Aborting: spawn: %m!\n", __PRETTY_FUNCTION__);
+		exit(EXIT_FAILURE);
+	}
+	close(pfd[1]);
+
+	// Wait for the write end to be closed by the exec
+	char    c;
+	ssize_t rc;
+	do {
+		rc = read(pfd[0], &c, sizeof(c));
+	} while (rc == -1 && errno == EINTR);
+	struct timespec t1 = { 0 };
+	clock_gettime(CLOCK_MONOTONIC_RAW, &t1);
+	close(pfd[0]);
+
+	wait(pid);
+
+	return (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_nsec - t0.tv_nsec) / 1000L;
+}
+
+static void
+    bench(const char* name, spawn_fn fn, wait_fn wait, char* const* command, unsigned int iterations)
+{
+	long min = -1L;
+	long max = 0L;
+	long sum = 0L;
+	for (unsigned int i = 0U; i < iterations; i++) {
+		long us = bench_once(fn, wait, command);
+		if (min == -1L || us < min) {
+			min = us;
+		}
+		if (us > max) {
+			max = us;
+		}
+		sum += us;
+	}
+
+	fprintf(stdout,
+		"%-12s %u runs: min %ldus, avg %ldus, max %ldus\n",
+		name,
+		iterations,
+		min,
+		sum / (long) iterations,
+		max);
+}
+
+int
+    main(int argc, char* argv[])
+{
+	unsigned int iterations = 100U;
+	size_t       ballast_mb = 32U;
+
+	int opt;
+	while ((opt = getopt(argc, argv, "n:m:h")) != -1) {
+		switch (opt) {
+			case 'n':
+				iterations = (unsigned int) strtoul(optarg, NULL, 10);
+				break;
+			case 'm':
+				ballast_mb = (size_t) strtoul(optarg, NULL, 10);
+				break;
+			case 'h':
+			default:
+				fprintf(stderr, "Usage: %s [-n iterations] [-m ballast_MB] [command]\n", argv[0]);
+				exit(opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE);
+		}
+	}
+	if (iterations == 0U) {
+		iterations = 1U;
+	}
+
+	char         default_name[] = "true";
+	char*        default_cmd[]  = { default_name, NULL };
+	char* const* command        = optind < argc ? argv + optind : default_cmd;
+
+	pid_t zygote_pid = start_zygote(command);
+
+	// Touch every page, so that fork actually has page tables to copy
+	size_t   ballast_size = ballast_mb * 1024U * 1024U;
+	uint8_t* ballast      = NULL;
+	if (ballast_size > 0U) {
+		ballast = malloc(ballast_size);
+		if (ballast == NULL) {
+			fprintf(stderr, "[%s] Aborting: malloc: %m!\n", __PRETTY_FUNCTION__);
+			exit(EXIT_FAILURE);
+		}
+		memset(ballast, 0x42, ballast_size);
+		// Don't let the compiler elide that as a dead store
+		// NOTE: Without this, -O2 drops the memset, and the fork numbers are meaningless.
+		__asm__ __volatile__("" : : "r"(ballast) : "memory");
+		// And check that it actually worked, so that never goes unnoticed
+		long rss_kb = get_rss_kb();
+		if (rss_kb != -1L && rss_kb < (long) (ballast_mb * 1024U)) {
+			fprintf(stderr, "The ballast isn't resident, the numbers below are meaningless!\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	fprintf(stdout, "Spawning %s with %zuMB of dirty ballast\n", *command, ballast_mb);
+	print_mem("self", getpid());
+	print_mem("zygote", zygote_pid);
+	bench("fork", spawn_fork, wait_child, command, iterations);
+	bench("posix_spawn", spawn_posix, wait_child, command, iterations);
+	bench("clone", spawn_clone, wait_child, command, iterations);
+	bench("zygote", spawn_zygote, wait_zygote, command, iterations);
+
+	close(zygote_fd);
+	waitpid(zygote_pid, NULL, 0);
+
+	free(ballast);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,83 @@
+/*
+	KFMon: Kobo inotify-based launcher
+	Copyright (C) 2016-2024 NiLuJe <ninuje@gmail.com>
+	SPDX-License-Identifier: GPL-3.0-or-later
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+// Layout of KFMon's read-only state page, shared by the daemon and its clients.
+
+#ifndef __KFMON_STATE_PAGE_H
+#define __KFMON_STATE_PAGE_H
+
+#include <stdint.h>
+
+// KFMon publishes a snapshot of its state in a small file, meant to be mmap'ed (read-only, MAP_SHARED) by frontends,
+// so that they can poll it at any rate, without an IPC round-trip, and without waking the daemon up.
+// It's refreshed whenever the watch table or the process table changes, before KFMon goes back to sleep.
+// NOTE: The page is protected by a seqlock: seq is odd while KFMon is updating it.
+//       Readers have to load seq (acquire), bail if it's odd, copy what they need, issue an acquire fence,
+//       and retry if seq has changed in the meantime (c.f., kfmon_state_snapshot in utils/libkfmonipc.c).
+// NOTE: The file outlives KFMon, check that kfmon_pid is still alive before trusting it.
+//       A new instance publishes a brand new file (it never reuses the previous one), so re-map it when that happens.
+#ifndef KFMON_STATE_PAGE
+#	define KFMON_STATE_PAGE "/var/run/kfmon.state"
+#endif
+
+// "KFMS", in little-endian
+#define KFMON_STATE_PAGE_MAGIC   0x534D464BU
+#define KFMON_STATE_PAGE_VERSION 1U
+// Matches the daemon's WATCH_MAX & CFG_SZ_MAX
+#define KFMON_STATE_WATCH_MAX    16U
+#define KFMON_STATE_NAME_MAX     128U
+
+// KFMonStateWatch flags
+#define KFMON_STATE_WATCH_ACTIVE  (1U << 0U)
+#define KFMON_STATE_WATCH_HIDDEN  (1U << 1U)
+#define KFMON_STATE_WATCH_BLOCKER (1U << 2U)
+
+typedef struct
+{
+	// pid of its running process, -1 if none
+	int32_t pid;
+	// KFMON_STATE_WATCH_* flags (a slot w/o KFMON_STATE_WATCH_ACTIVE is unused)
+	uint8_t flags;
+	uint8_t reserved[3];
+	// Basename of the trigger file (i.e., what trigger:<name> expects), and label, both NUL-terminated
+	char    name[KFMON_STATE_NAME_MAX];
+	char    label[KFMON_STATE_NAME_MAX];
+} KFMonStateWatch;
+
+typedef struct
+{
+	uint32_t        magic;
+	uint16_t        version;
+	// sizeof(KFMonStatePage)
+	uint16_t        size;
+	uint32_t        seq;
+	// Bumped on every update
+	uint32_t        gen;
+	// Bumped whenever the watch table itself changes (i.e., anything but the pids)
+	uint32_t        watch_gen;
+	int32_t         kfmon_pid;
+	// Whether a spawn blocker (i.e., a watch w/ block_spawns) is running
+	uint8_t         blocked;
+	uint8_t         reserved[3];
+	// Indexed by watch id (i.e., the ids used by the IPC commands)
+	KFMonStateWatch watches[KFMON_STATE_WATCH_MAX];
+} KFMonStatePage;
+
+#endif